@@ -36,6 +36,8 @@ fi
 BLOCK_SIZE_MIN=256
 BLOCK_SIZE_MAX=256
 NB_MEASURES=10
+# storage of the matrix (the results are stored in a sub directory per layout)
+declare -a LAYOUTS=("row" "tile")
 # threads for the tasks.
 # strings: "d c u s v" (diagonal column update)
 declare -a THREADS=(
@@ -101,10 +103,13 @@ manual_test() {
 # Run the test compiled inside the program (avoid reloading the matrix file).
 # Note: the output form is different compared to the manual version.
 automatic_test() {
-  for ((blockSize=$BLOCK_SIZE_MIN; blockSize<=$BLOCK_SIZE_MAX; blockSize*=2)); do
-    timefile=$RESULT_OUTPUT_DIR/times-$1-$blockSize.txt
-    echo "$CHOLESKY -g $RESULT_OUTPUT_DIR -i $MATRIX_FILES_DIR/$1.in -l 1 -b $blockSize >> $timefile"
-    $CHOLESKY -g $RESULT_OUTPUT_DIR -i $MATRIX_FILES_DIR/$1.in -l 1 -b $blockSize >> $timefile
+  for layout in "${LAYOUTS[@]}"; do
+    mkdir -p $RESULT_OUTPUT_DIR/$layout
+    for ((blockSize=$BLOCK_SIZE_MIN; blockSize<=$BLOCK_SIZE_MAX; blockSize*=2)); do
+      timefile=$RESULT_OUTPUT_DIR/$layout/times-$1-$blockSize.txt
+      echo "$CHOLESKY -g $RESULT_OUTPUT_DIR/$layout -i $MATRIX_FILES_DIR/$1.in -l 1 -b $blockSize -y $layout >> $timefile"
+      $CHOLESKY -g $RESULT_OUTPUT_DIR/$layout -i $MATRIX_FILES_DIR/$1.in -l 1 -b $blockSize -y $layout >> $timefile
+    done
   done
 }
 
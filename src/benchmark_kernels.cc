@@ -0,0 +1,160 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#include "kernels/tile_kernels.h"
+#include <cblas.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#define NB_MEASURES 10
+
+/// Compares the fixed size tile kernels (TileKernels<T, B>) with the generic ones (GenericKernels)
+/// for each specialized block size. The tiles are stored with ld = B (tile major layout). Each
+/// measure is the best time per call over NB_MEASURES repetitions.
+
+template <typename T>
+struct Tiles {
+  explicit Tiles(size_t b) : b(b), spd(b * b), l(b * b), x(b * b), y(b * b), c(b * b), work(b * b) {
+    std::mt19937 generator(b);
+    std::uniform_real_distribution<T> distribution(-1, 1);
+
+    for (auto *tile : {&x, &y, &c}) {
+      for (auto &value : *tile) {
+        value = distribution(generator);
+      }
+    }
+    // spd = x.x^T + b.I, l is its factor
+    for (size_t i = 0; i < b; ++i) {
+      for (size_t j = 0; j < b; ++j) {
+        spd[i * b + j] = i == j ? T(b) : T(0);
+      }
+    }
+    blas::gemm(CblasNoTrans, CblasTrans, (int32_t) b, (int32_t) b, (int32_t) b, T(1), x.data(),
+               (int32_t) b, x.data(), (int32_t) b, T(1), spd.data(), (int32_t) b);
+    l = spd;
+    GenericKernels<T>::potrf(b, l.data(), b);
+  }
+
+  size_t b;
+  std::vector<T> spd, l, x, y, c, work;
+};
+
+/// @brief Best time of function in microseconds, the input is restored before each call.
+template <typename Function>
+double measure(size_t nbCalls, Function &&function) {
+  double best = INFINITY;
+
+  for (size_t measure = 0; measure < NB_MEASURES; ++measure) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t call = 0; call < nbCalls; ++call) {
+      function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::micro>(end - begin).count() / (double) nbCalls);
+  }
+  return best;
+}
+
+/// @brief Maximum difference between the lower parts of a and b.
+template <typename T>
+T difference(std::vector<T> const &a, std::vector<T> const &b, size_t size, bool lower) {
+  T diff = 0;
+
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < (lower ? i + 1 : size); ++j) {
+      diff = std::max(diff, std::abs(a[i * size + j] - b[i * size + j]));
+    }
+  }
+  return diff;
+}
+
+template <typename T, typename Kernels>
+void run(Tiles<T> &tiles, size_t nbCalls, double *times, std::vector<T> *results) {
+  size_t b = tiles.b;
+
+  times[0] = measure(nbCalls, [&]() {
+    std::copy(tiles.spd.begin(), tiles.spd.end(), tiles.work.begin());
+    Kernels::potrf(b, tiles.work.data(), b);
+  });
+  results[0] = tiles.work;
+  times[1] = measure(nbCalls, [&]() {
+    std::copy(tiles.y.begin(), tiles.y.end(), tiles.work.begin());
+    Kernels::trsm(b, b, tiles.l.data(), b, tiles.work.data(), b);
+  });
+  results[1] = tiles.work;
+  times[2] = measure(nbCalls, [&]() {
+    std::copy(tiles.c.begin(), tiles.c.end(), tiles.work.begin());
+    Kernels::gemm(b, b, b, tiles.x.data(), b, tiles.y.data(), b, tiles.work.data(), b);
+  });
+  results[2] = tiles.work;
+  times[3] = measure(nbCalls, [&]() {
+    std::copy(tiles.c.begin(), tiles.c.end(), tiles.work.begin());
+    Kernels::syrk(b, b, tiles.x.data(), b, tiles.work.data(), b);
+  });
+  results[3] = tiles.work;
+  auto panels = Kernels::pack(b, b, tiles.y.data(), b); // packed once as done by the column task
+  times[4] = measure(nbCalls, [&]() {
+    std::copy(tiles.c.begin(), tiles.c.end(), tiles.work.begin());
+    Kernels::gemmPacked(b, b, b, tiles.x.data(), b, tiles.y.data(), b, panels.get(), tiles.work.data(), b);
+  });
+  results[4] = tiles.work;
+}
+
+template <typename T, size_t B>
+void benchmark(char const *type) {
+  Tiles<T> tiles(B);
+  size_t nbCalls = std::max<size_t>(1, (size_t(1) << 24) / (B * B * B));
+  char const *names[] = {"potrf", "trsm", "gemm", "syrk", "gemmP"};
+  double genericTimes[5], fixedTimes[5];
+  std::vector<T> genericResults[5], fixedResults[5];
+
+  run<T, GenericKernels<T>>(tiles, nbCalls, genericTimes, genericResults);
+  run<T, TileKernels<T, B>>(tiles, nbCalls, fixedTimes, fixedResults);
+
+  for (size_t kernel = 0; kernel < 5; ++kernel) {
+    std::cout << std::setw(6) << type << std::setw(5) << B << std::setw(7) << names[kernel]
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << genericTimes[kernel] << "us"
+              << std::setw(12) << fixedTimes[kernel] << "us"
+              << std::setw(8) << genericTimes[kernel] / fixedTimes[kernel] << "x"
+              << std::scientific << std::setprecision(1)
+              << std::setw(10) << difference(genericResults[kernel], fixedResults[kernel], B, kernel == 0 || kernel == 3)
+              << std::endl;
+  }
+}
+
+template <typename T>
+void benchmark(char const *type) {
+  benchmark<T, 16>(type);
+  benchmark<T, 32>(type);
+  benchmark<T, 64>(type);
+  benchmark<T, 128>(type);
+  benchmark<T, 256>(type);
+}
+
+int main() {
+  openblas_set_num_threads(1);
+  std::cout << "  type    B kernel     generic       fixed speedup      diff" << std::endl;
+  benchmark<double>("double");
+  benchmark<float>("float");
+  return 0;
+}
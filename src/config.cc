@@ -49,6 +49,8 @@ void parseCmdArgs(int argc, char **argv, Config &config) {
     cmd.add(nbThreadsUpdateArg);
     TCLAP::ValueArg<size_t> nbThreadsComputeDiagonalArg("d", "diagonal", "Number of threads for the compute diagonal task.", false, 1, &sc);
     cmd.add(nbThreadsComputeDiagonalArg);
+    TCLAP::ValueArg<size_t> nbThreadsFactorDiagonalArg("D", "diagThreads", "Number of threads used to factorize one diagonal block (recursive algorithm, blocks larger than 128).", false, 1, &sc);
+    cmd.add(nbThreadsFactorDiagonalArg);
     TCLAP::ValueArg<size_t> nbThreadsSolveDiagonalArg("s", "solDiag", "Number of threads for the solve diagonal task.", false, 1, &sc);
     cmd.add(nbThreadsSolveDiagonalArg);
     TCLAP::ValueArg<size_t> nbThreadsUpdateVectorArg("v", "upVec", "Number of threads for the update vector task.", false, 4, &sc);
@@ -57,6 +59,40 @@ void parseCmdArgs(int argc, char **argv, Config &config) {
     cmd.add(loopArg);
     TCLAP::ValueArg<bool> printArg("p", "print", "print", false, false, "bool");
     cmd.add(printArg);
+    TCLAP::ValueArg<bool> streamArg("t", "stream", "Read the matrix while the decomposition is running", false, false, "bool");
+    cmd.add(streamArg);
+    std::vector<std::string> layouts = {"row", "tile"};
+    TCLAP::ValuesConstraint<std::string> layoutConstraint(layouts);
+    TCLAP::ValueArg<std::string> layoutArg("y", "layout", "Storage of the matrix (row major or tile major)", false, "row", &layoutConstraint);
+    cmd.add(layoutArg);
+    TCLAP::ValueArg<bool> hugePagesArg("H", "hugepages", "Use 2MB pages for the matrix buffers", false, false, "bool");
+    cmd.add(hugePagesArg);
+    std::vector<std::string> numaPlacements = {"none", "interleave", "cyclic"};
+    TCLAP::ValuesConstraint<std::string> numaConstraint(numaPlacements);
+    TCLAP::ValueArg<std::string> numaArg("n", "numa", "Placement of the tiles on the NUMA nodes", false, "none", &numaConstraint);
+    cmd.add(numaArg);
+    TCLAP::ValueArg<std::string> tileFileArg("o", "ooc", "Out-of-core mode: file used to store the tiles", false, "", "string");
+    cmd.add(tileFileArg);
+    TCLAP::ValueArg<size_t> cacheSizeArg("C", "cache", "Size of the tile cache in MB (out-of-core mode)", false, 1024, &sc);
+    cmd.add(cacheSizeArg);
+    TCLAP::ValueArg<std::string> outputFileArg("w", "write", "Write L and the solution in a packed file", false, "", "string");
+    cmd.add(outputFileArg);
+    std::vector<std::string> precisions = {"double", "float", "mixed"};
+    TCLAP::ValuesConstraint<std::string> precisionConstraint(precisions);
+    TCLAP::ValueArg<std::string> precisionArg("P", "precision", "Scalar type used for the computation (float requires a float packed file, mixed factorizes in float and refines the solution in double)", false, "double", &precisionConstraint);
+    cmd.add(precisionArg);
+    TCLAP::ValueArg<size_t> refinementStepsArg("R", "refine", "Maximum number of steps of the iterative refinement (mixed precision)", false, 10, &sc);
+    cmd.add(refinementStepsArg);
+    std::vector<std::string> algorithms = {"right", "left"};
+    TCLAP::ValuesConstraint<std::string> algorithmConstraint(algorithms);
+    TCLAP::ValueArg<std::string> algorithmArg("a", "algorithm", "Variant of the decomposition (right looking or left looking)", false, "right", &algorithmConstraint);
+    cmd.add(algorithmArg);
+    TCLAP::ValueArg<size_t> lookaheadArg("L", "lookahead", "Number of columns whose updates are sent before the rest of the trailing updates (right looking)", false, 1, "size_t");
+    cmd.add(lookaheadArg);
+    TCLAP::ValueArg<bool> autotuneArg("A", "autotune", "Choose the block size from measures of the tile kernels on this machine (replaces -b)", false, false, "bool");
+    cmd.add(autotuneArg);
+    TCLAP::ValueArg<std::string> tuningFileArg("T", "tuning", "File where the autotuner stores its measures and choices", false, "cholesky-hh.tuning", "string");
+    cmd.add(tuningFileArg);
     cmd.parse(argc, argv);
 
     config.inputFile = inputFileArg.getValue();
@@ -65,10 +101,36 @@ void parseCmdArgs(int argc, char **argv, Config &config) {
     config.threadsConfig.nbThreadsComputeColumnTask = nbThreadsComputeColumnArg.getValue();
     config.threadsConfig.nbThreadsUpdateTask = nbThreadsUpdateArg.getValue();
     config.threadsConfig.nbThreadsComputeDiagonalTask = nbThreadsComputeDiagonalArg.getValue();
+    config.threadsConfig.nbThreadsFactorDiagonal = nbThreadsFactorDiagonalArg.getValue();
     config.threadsConfig.nbThreadsSolveDiagonal = nbThreadsSolveDiagonalArg.getValue();
     config.threadsConfig.nbThreadsUpdateVector = nbThreadsUpdateVectorArg.getValue();
     config.print = printArg.getValue();
     config.loop = loopArg.getValue();
+    config.stream = streamArg.getValue();
+    config.hugePages = hugePagesArg.getValue();
+    if (numaArg.getValue() == "interleave") {
+      config.numa = NumaPlacements::Interleave;
+    } else if (numaArg.getValue() == "cyclic") {
+      config.numa = NumaPlacements::BlockCyclic;
+    } else {
+      config.numa = NumaPlacements::None;
+    }
+    config.layout = layoutArg.getValue() == "tile" ? MatrixLayouts::TileMajor : MatrixLayouts::RowMajor;
+    config.tileFile = tileFileArg.getValue();
+    config.cacheSize = cacheSizeArg.getValue();
+    config.outputFile = outputFileArg.getValue();
+    if (precisionArg.getValue() == "float") {
+      config.precision = Precisions::Float;
+    } else if (precisionArg.getValue() == "mixed") {
+      config.precision = Precisions::Mixed;
+    } else {
+      config.precision = Precisions::Double;
+    }
+    config.refinementSteps = refinementStepsArg.getValue();
+    config.algorithm = algorithmArg.getValue() == "left" ? Algorithms::LeftLooking : Algorithms::RightLooking;
+    config.lookahead = lookaheadArg.getValue();
+    config.autotune = autotuneArg.getValue();
+    config.tuningFile = tuningFileArg.getValue();
   } catch (TCLAP::ArgException &e)  // catch any exceptions
   { std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl; }
 }
@@ -19,6 +19,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 #include <string>
+#include "data/matrix_types.h"
+#include "memory/numa_placements.h"
 
 struct ThreadsConfig {
   ThreadsConfig() {}
@@ -26,18 +28,32 @@ struct ThreadsConfig {
                 size_t nbThreadsComputeColumnTask,
                 size_t nbThreadsUpdateTask,
                 size_t nbThreadsSolveDiagonal,
-                size_t nbThreadsUpdateVector)
+                size_t nbThreadsUpdateVector,
+                size_t nbThreadsFactorDiagonal = 1)
       : nbThreadsComputeDiagonalTask(nbThreadsComputeDiagonalTask),
         nbThreadsComputeColumnTask(nbThreadsComputeColumnTask),
         nbThreadsUpdateTask(nbThreadsUpdateTask),
         nbThreadsSolveDiagonal(nbThreadsSolveDiagonal),
-        nbThreadsUpdateVector(nbThreadsUpdateVector) {}
+        nbThreadsUpdateVector(nbThreadsUpdateVector),
+        nbThreadsFactorDiagonal(nbThreadsFactorDiagonal) {}
 
   size_t nbThreadsComputeDiagonalTask = 1;
   size_t nbThreadsComputeColumnTask = 8;
   size_t nbThreadsUpdateTask = 35;
   size_t nbThreadsSolveDiagonal = 8;
   size_t nbThreadsUpdateVector = 30;
+  size_t nbThreadsFactorDiagonal = 1; // threads used to factorize one diagonal block
+};
+
+enum class Precisions {
+  Double,
+  Float,
+  Mixed, // factorization in float, iterative refinement of the solution in double
+};
+
+enum class Algorithms {
+  RightLooking, // the blocks are updated as soon as a column is decomposed
+  LeftLooking,  // each block receives all its updates at once, just before it is decomposed
 };
 
 struct Config {
@@ -46,6 +62,19 @@ struct Config {
   size_t blockSize;
   bool print;
   bool loop;
+  bool stream;
+  MatrixLayouts layout;
+  bool hugePages;
+  NumaPlacements numa;
+  std::string tileFile;  // out-of-core mode when not empty
+  size_t cacheSize;      // size of the tile cache in MB
+  std::string outputFile; // L and x are written in this file when not empty
+  Precisions precision;
+  size_t refinementSteps; // maximum number of steps of the iterative refinement (mixed precision)
+  Algorithms algorithm;
+  size_t lookahead;       // number of columns whose updates are sent before the trailing updates
+  bool autotune;          // the block size is chosen by the autotuner (see tuning.h)
+  std::string tuningFile; // measures and choices of the autotuner
   ThreadsConfig threadsConfig;
 };
 
@@ -0,0 +1,78 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#include "tclap/CmdLine.h"
+#include "io/mapped_file.h"
+#include "io/packed_format.h"
+#include <iostream>
+
+using MatrixType = double;
+
+/// @brief Converts a cholesky-hh input file (full row major matrices) to the packed format.
+int main(int argc, char **argv) {
+  try {
+    TCLAP::CmdLine cmd("Cholesky Hedgehog input file converter", ' ', "0.1");
+    TCLAP::ValueArg<std::string> inputFileArg("i", "input", "Input file name", true, "", "string");
+    cmd.add(inputFileArg);
+    TCLAP::ValueArg<std::string> outputFileArg("o", "output", "Output file name", true, "", "string");
+    cmd.add(outputFileArg);
+    TCLAP::ValueArg<size_t> blockSizeArg("b", "blocksize", "Size of the tiles in the output file", false, 10, "size_t");
+    cmd.add(blockSizeArg);
+    std::vector<std::string> precisions = {"double", "float"};
+    TCLAP::ValuesConstraint<std::string> precisionConstraint(precisions);
+    TCLAP::ValueArg<std::string> precisionArg("p", "precision", "Scalar type of the output file", false, "double", &precisionConstraint);
+    cmd.add(precisionArg);
+    cmd.parse(argc, argv);
+
+    MappedFile input(inputFileArg.getValue());
+    size_t width = *input.at<size_t>(0);
+    size_t height = *input.at<size_t>(sizeof(size_t));
+    size_t blockSize = blockSizeArg.getValue();
+    size_t matrixOffset = 2 * sizeof(size_t);
+    size_t resultOffset = matrixOffset + width * height * sizeof(MatrixType);
+    size_t triangularOffset = resultOffset + height * sizeof(MatrixType);
+    size_t solutionOffset = triangularOffset + width * height * sizeof(MatrixType);
+    bool hasExpected = input.size() >= solutionOffset + height * sizeof(MatrixType);
+
+    if (width != height || blockSize == 0 || input.size() < triangularOffset) {
+      std::cerr << "error: invalid input file " << inputFileArg.getValue() << std::endl;
+      return 1;
+    }
+    input.advise(0, input.size(), MADV_SEQUENTIAL);
+
+    MatrixData<MatrixType, MatrixTypes::Matrix> matrix(width, height, blockSize, input.at<MatrixType>(matrixOffset));
+    MatrixData<MatrixType, MatrixTypes::Vector> result(1, height, blockSize, input.at<MatrixType>(resultOffset));
+    MatrixData<MatrixType, MatrixTypes::Matrix> triangular(width, height, blockSize, input.at<MatrixType>(triangularOffset));
+    MatrixData<MatrixType, MatrixTypes::Vector> solution(1, height, blockSize, input.at<MatrixType>(solutionOffset));
+
+    if (precisionArg.getValue() == "float") {
+      writePacked<MatrixType, float>(outputFileArg.getValue(), blockSize, matrix, result,
+                                     hasExpected ? &triangular : nullptr, hasExpected ? &solution : nullptr);
+    } else {
+      writePacked(outputFileArg.getValue(), blockSize, matrix, result,
+                  hasExpected ? &triangular : nullptr, hasExpected ? &solution : nullptr);
+    }
+  } catch (TCLAP::ArgException &e) {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+    return 1;
+  } catch (std::runtime_error &e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -20,83 +20,151 @@
 #define MATRIX_BLOCK_DATA_H
 
 #include "block_types.h"
+#include "../memory/message_pool.h"
+#include "../memory/tile_cache.h"
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <memory>
 #include <hedgehog/hedgehog.h>
 
+/// @brief Description of a block of the matrix: its geometry, its position and its rank. It is
+/// shared by all the messages that refer to the block, so there is a single rank per block. The
+/// rank is written by a state and read by the others (and by the tasks), it is published with
+/// release stores and read with acquire loads.
+template <typename T>
+struct BlockDescriptor {
+  BlockDescriptor(size_t width, size_t height, size_t nbBlocksRows, size_t nbBlocksCols, size_t x,
+                  size_t y, size_t matrixWidth, size_t matrixHeight, size_t ld, T *fullMatrix)
+          : width(width), height(height), nbBlocksRows(nbBlocksRows), nbBlocksCols(nbBlocksCols),
+            x(x), y(y), matrixWidth(matrixWidth), matrixHeight(matrixHeight), ld(ld),
+            fullMatrix(fullMatrix) {}
+
+  /// @brief Copy used by MatrixBlockData::detach (the rank is copied with its current value).
+  BlockDescriptor(BlockDescriptor const &other)
+          : width(other.width), height(other.height), nbBlocksRows(other.nbBlocksRows),
+            nbBlocksCols(other.nbBlocksCols), x(other.x), y(other.y),
+            matrixWidth(other.matrixWidth), matrixHeight(other.matrixHeight), ld(other.ld),
+            rank(other.rank.load(std::memory_order_acquire)), fullMatrix(other.fullMatrix),
+            cache(other.cache) {}
+
+  BlockDescriptor &operator=(BlockDescriptor const &) = delete;
+
+  size_t width = 0;
+  size_t height = 0;
+  size_t nbBlocksRows = 0;
+  size_t nbBlocksCols = 0;
+  size_t x = 0;
+  size_t y = 0;
+  size_t matrixWidth = 0;
+  size_t matrixHeight = 0;
+  size_t ld = 0;
+  std::atomic<size_t> rank = 0;
+  T *fullMatrix = nullptr;
+  TileCache<T> *cache = nullptr;
+};
+
+/// @brief Typed handle on a block of the matrix, the type (BlockType) is used by hedgehog to route
+/// the block. Changing the type of a block only copies the pointer to the shared descriptor, the
+/// handle only keeps the pointer to the data (it changes when the block is acquired in out-of-core
+/// mode) and the packed copy of the block.
 template <typename T, BlockTypes BlockType>
 class MatrixBlockData {
  public:
   MatrixBlockData(size_t width, size_t height, size_t nbBlocksRows, size_t nbBlocksCols, size_t x,
-                  size_t y, size_t matrixWidth, size_t matrixHeight, T *ptr, T *fullMatrix)
-          : width_(width), height_(height), nbBlocksRows_(nbBlocksRows),
-            nbBlocksCols_(nbBlocksCols), x_(x), y_(y), matrixWidth_(matrixWidth),
-            matrixHeight_(matrixHeight), ptr_(ptr), fullMatrix_(fullMatrix) {}
-
-  template <BlockTypes OtherType>
-  explicit MatrixBlockData(std::shared_ptr<MatrixBlockData<T, OtherType>> &other)
-          : MatrixBlockData(other->width(), other->height(), other->nbBlocksRows(),
-                            other->nbBlocksCols(), other->x(), other->y(), other->matrixWidth(),
-                            other->matrixHeight(), other->get(), other->fullMatrix()) {
-    rank_ = other->rank();
-  }
+                  size_t y, size_t matrixWidth, size_t matrixHeight, size_t ld, T *ptr, T *fullMatrix)
+          : block_(std::make_shared<BlockDescriptor<T>>(
+                  width, height, nbBlocksRows, nbBlocksCols, x, y, matrixWidth, matrixHeight, ld,
+                  fullMatrix)),
+            ptr_(ptr) {}
 
   template <BlockTypes OtherType>
-  explicit MatrixBlockData(std::shared_ptr<MatrixBlockData<T, OtherType>> &&other)
-          : MatrixBlockData(other->width(), other->height(), other->nbBlocksRows(),
-                            other->nbBlocksCols(), other->x(), other->y(), other->matrixWidth(),
-                            other->matrixHeight(), other->get(), other->fullMatrix()) {
-    rank_ = other->rank();
-  }
+  explicit MatrixBlockData(std::shared_ptr<MatrixBlockData<T, OtherType>> const &other)
+          : block_(other->block_), ptr_(other->ptr_) {}
 
   template <BlockTypes OtherType>
   explicit MatrixBlockData(MatrixBlockData<T, OtherType> &&other)
-          : MatrixBlockData(other.width(), other.height(), other.nbBlocksRows(),
-                            other.nbBlocksCols(), other.x(), other.y(), other.matrixWidth(),
-                            other.matrixHeight(), other.get(), other.fullMatrix()) {
-    rank_ = other.rank();
-  }
+          : block_(std::move(other.block_)), ptr_(other.ptr_) {}
+
+  [[nodiscard]] size_t width() const { return block_->width; }
+  [[nodiscard]] size_t height() const { return block_->height; }
 
-  [[nodiscard]] size_t width() const { return width_; }
-  [[nodiscard]] size_t height() const { return height_; }
+  [[nodiscard]] size_t nbBlocksRows() const { return block_->nbBlocksRows; }
+  [[nodiscard]] size_t nbBlocksCols() const { return block_->nbBlocksCols; }
 
-  [[nodiscard]] size_t nbBlocksRows() const { return nbBlocksRows_; }
-  [[nodiscard]] size_t nbBlocksCols() const { return nbBlocksCols_; }
+  [[nodiscard]] size_t x() const { return block_->x; }
+  [[nodiscard]] size_t y() const { return block_->y; }
 
-  [[nodiscard]] size_t x() const { return x_; }
-  [[nodiscard]] size_t y() const { return y_; }
-  void x(size_t x) { this->x_ = x; }
-  void y(size_t y) { this->y_ = y; }
+  [[nodiscard]] size_t matrixWidth() const { return block_->matrixWidth; }
+  [[nodiscard]] size_t matrixHeight() const { return block_->matrixHeight; }
 
-  [[nodiscard]] size_t matrixWidth() const { return matrixWidth_; }
-  [[nodiscard]] size_t matrixHeight() const { return matrixHeight_; }
+  /// @brief leading dimension of the block (depends on the layout of the matrix)
+  [[nodiscard]] size_t ld() const { return block_->ld; }
 
-  [[nodiscard]] size_t rank() const { return rank_; }
-  size_t incRank() { return ++rank_; }
-  size_t decRank() { return --rank_; }
-  void rank(size_t rank) { rank_ = rank; }
+  [[nodiscard]] size_t rank() const { return block_->rank.load(std::memory_order_acquire); }
+  size_t incRank() { return block_->rank.fetch_add(1, std::memory_order_acq_rel) + 1; }
+  size_t decRank() { return block_->rank.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+  void rank(size_t rank) { block_->rank.store(rank, std::memory_order_release); }
+
+  /// @brief Gives a private copy of the descriptor to the handle, used when the rank of the block
+  /// takes another meaning while the other handles still use the old one (second solver phase).
+  void detach() { block_ = std::make_shared<BlockDescriptor<T>>(*block_); }
 
   // helper functions to simplify tests
-  [[nodiscard]] bool isProcessed() const { return rank_ > x_; }
-  [[nodiscard]] bool isReady() const { return rank_ == x_; }
-  [[nodiscard]] bool isUpdateable(size_t rank) const { return rank_ == rank - 1; }
-  [[nodiscard]] bool isDiag() const { return y_ == x_; }
+  [[nodiscard]] bool isProcessed() const { return rank() > block_->x; }
+  [[nodiscard]] bool isReady() const { return rank() == block_->x; }
+  [[nodiscard]] bool isUpdateable(size_t rank) const { return this->rank() == rank - 1; }
+  [[nodiscard]] bool isDiag() const { return block_->y == block_->x; }
 
-  [[nodiscard]] size_t idx() const { return y_ * nbBlocksCols_ + x_; }
-  [[nodiscard]] size_t diagIdx() const { return x_ * nbBlocksCols_ + x_; }
+  [[nodiscard]] size_t idx() const { return block_->y * block_->nbBlocksCols + block_->x; }
+  [[nodiscard]] size_t diagIdx() const { return block_->x * block_->nbBlocksCols + block_->x; }
 
-  T *fullMatrix() { return fullMatrix_; }
+  T *fullMatrix() { return block_->fullMatrix; }
   T *get() { return ptr_; }
 
+  /// @brief tile cache used in out-of-core mode (nullptr when the matrix is in memory)
+  [[nodiscard]] TileCache<T> *cache() const { return block_->cache; }
+  void cache(TileCache<T> *cache) { block_->cache = cache; }
+
+  /// @brief Loads the block in the cache and pins it (no-op when the matrix is in memory). The
+  /// states acquire the blocks just before sending them to a task.
+  void acquire() {
+    if (block_->cache) {
+      T *ptr = block_->cache->acquire(idx());
+      if (ptr != ptr_) {
+        ptr_ = ptr;
+      }
+    }
+  }
+
+  /// @brief Unpins the block, the tasks release the blocks once the computation is done.
+  void release(bool dirty = false, bool final = false) {
+    if (block_->cache) {
+      block_->cache->release(idx(), dirty, final);
+    }
+  }
+
+  /// @brief Packed copy of the block for the fixed-size update kernels (only set on the column
+  /// blocks). It is not copied when the block changes of type, so the buffer is freed once the last
+  /// update that uses it is done.
+  [[nodiscard]] std::shared_ptr<T[]> const &packed() const { return packed_; }
+  void packed(std::shared_ptr<T[]> packed) { packed_ = std::move(packed); }
+
+  void prefetch() {
+    if (block_->cache) {
+      block_->cache->prefetch(idx());
+    }
+  }
+
   // helper function (warn: we use i and j here and not x and y so it's
   // inverted)
-  T &at(size_t i, size_t j) { return ptr_[i * matrixWidth_ + j]; }
-  T &fullMatrixAt(size_t i, size_t j) { return fullMatrix_[i * matrixWidth_ + j]; }
+  T &at(size_t i, size_t j) { return ptr_[i * block_->ld + j]; }
+  // only valid for row major matrices
+  T &fullMatrixAt(size_t i, size_t j) { return block_->fullMatrix[i * block_->matrixWidth + j]; }
 
   friend std::ostream &
   operator<<(std::ostream &os, const MatrixBlockData<T, BlockType> &block) {
-    os << block.x_ << " " << block.y_ << " (" << block.rank_ << ")";
+    os << block.x() << " " << block.y() << " (" << block.rank() << ")";
     return os;
   }
 
@@ -111,18 +179,11 @@ class MatrixBlockData {
   }
 
  private:
-  size_t width_ = 0;
-  size_t height_ = 0;
-  size_t nbBlocksRows_ = 0;
-  size_t nbBlocksCols_ = 0;
-  size_t x_ = 0;
-  size_t y_ = 0;
-  size_t matrixWidth_ = 0;
-  size_t matrixHeight_ = 0;
-  size_t rank_ = 0;
-//  bool isReady_ = false;
+  template <typename, BlockTypes> friend class MatrixBlockData;
+
+  std::shared_ptr<BlockDescriptor<T>> block_ = nullptr;
   T *ptr_ = nullptr;
-  T *fullMatrix_ = nullptr;
+  std::shared_ptr<T[]> packed_ = nullptr;
 };
 
 #endif
@@ -23,17 +23,36 @@
 #include <hedgehog/hedgehog.h>
 #include <memory>
 #include "matrix_types.h"
+#include "../memory/arena.h"
+#include "../memory/tile_cache.h"
 
 template<typename T, MatrixTypes MT = MatrixTypes::Matrix>
 class MatrixData {
  public:
-  MatrixData(size_t width, size_t height, size_t blockSize, T *ptr)
+  MatrixData(size_t width, size_t height, size_t blockSize, T *ptr,
+             MatrixLayouts layout = MatrixLayouts::RowMajor)
           : width_(width), height_(height), blockSize_(blockSize),
             nbBlocksRows_((size_t) std::ceil(height / blockSize) +
                           (height % blockSize == 0 ? 0 : 1)),
             nbBlocksCols_((size_t) std::ceil(width / blockSize) +
                           (width % blockSize == 0 ? 0 : 1)),
-            ptr_(ptr) {}
+            layout_(layout), ptr_(ptr) {}
+
+  /// @brief Allocates the buffer of the matrix in the arena (the values are not initialized).
+  MatrixData(size_t width, size_t height, size_t blockSize, Arena &arena,
+             MatrixLayouts layout = MatrixLayouts::RowMajor)
+          : MatrixData(width, height, blockSize,
+                       arena.allocate<T>(bufferSize(width, height, blockSize, layout)), layout) {}
+
+  /// @brief Number of elements required to store the matrix with the given layout (the blocks on
+  /// the border are padded in the tile major layout).
+  static size_t bufferSize(size_t width, size_t height, size_t blockSize, MatrixLayouts layout) {
+    if (layout == MatrixLayouts::TileMajor) {
+      return (width / blockSize + (width % blockSize ? 1 : 0)) * blockSize
+           * (height / blockSize + (height % blockSize ? 1 : 0)) * blockSize;
+    }
+    return width * height;
+  }
 
   [[nodiscard]] size_t blockSize() const { return blockSize_; }
 
@@ -43,17 +62,51 @@ class MatrixData {
   [[nodiscard]] size_t width() const { return width_; }
   [[nodiscard]] size_t height() const { return height_; }
 
+  [[nodiscard]] MatrixLayouts layout() const { return layout_; }
+
+  [[nodiscard]] size_t index(size_t i, size_t j) const {
+    if (layout_ == MatrixLayouts::TileMajor) {
+      return ((i / blockSize_) * nbBlocksCols_ + j / blockSize_) * blockSize_ * blockSize_
+           + (i % blockSize_) * blockSize_ + j % blockSize_;
+    }
+    return i * width_ + j;
+  }
+
   [[nodiscard]] T at(size_t i, size_t j) const {
-    return ptr_[i * width_ + j];
+    return ptr_[index(i, j)];
   }
 
   [[nodiscard]] T *get() { return ptr_; }
 
+  /// @brief Out-of-core mode: the tiles are stored in the file of the cache and the matrix has
+  /// no buffer.
+  [[nodiscard]] TileCache<T> *cache() const { return cache_.get(); }
+  void cache(std::shared_ptr<TileCache<T>> cache) { cache_ = std::move(cache); }
+
+  /// @brief Pointer on the first element of the block (iBlock, jBlock).
+  [[nodiscard]] T *blockPtr(size_t iBlock, size_t jBlock) {
+    return ptr_ + index(iBlock * blockSize_, jBlock * blockSize_);
+  }
+
+  /// @brief Leading dimension of the blocks.
+  [[nodiscard]] size_t blockLd() const {
+    return layout_ == MatrixLayouts::TileMajor ? blockSize_ : width_;
+  }
+
+  /// @brief Copies the values of the given matrix (the layouts can be different).
   void reset(const std::shared_ptr<MatrixData<T, MT>> &matrix) {
-    size_t size = matrix->width_ * matrix->height_;
+    if (matrix->layout_ == layout_ && matrix->blockSize_ == blockSize_) {
+      size_t size = bufferSize(width_, height_, blockSize_, layout_);
 
-    for (size_t i = 0;  i < size; ++i) {
-      this->ptr_[i] = matrix->get()[i];
+      for (size_t i = 0;  i < size; ++i) {
+        this->ptr_[i] = matrix->get()[i];
+      }
+    } else {
+      for (size_t i = 0; i < height_; ++i) {
+        for (size_t j = 0; j < width_; ++j) {
+          this->ptr_[index(i, j)] = matrix->at(i, j);
+        }
+      }
     }
   }
 
@@ -63,7 +116,7 @@ class MatrixData {
     } else {
       for (size_t i = 0; i < matrix->height(); ++i) {
         for (size_t j = 0; j < matrix->width(); ++j) {
-          os << matrix->ptr_[i * matrix->width() + j] << " ";
+          os << matrix->at(i, j) << " ";
         }
         os << std::endl;
       }
@@ -77,7 +130,9 @@ class MatrixData {
   size_t blockSize_ = 0;
   size_t nbBlocksRows_ = 0;
   size_t nbBlocksCols_ = 0;
+  MatrixLayouts layout_ = MatrixLayouts::RowMajor;
   T *ptr_ = nullptr;
+  std::shared_ptr<TileCache<T>> cache_ = nullptr;
 };
 
 #endif
@@ -19,9 +19,29 @@
 #ifndef CHOLESKY_HH_MATRIX_TYPES_H
 #define CHOLESKY_HH_MATRIX_TYPES_H
 
+#include <cstdint>
+#include <type_traits>
+
 enum class MatrixTypes {
   Matrix,
   Vector,
 };
 
+enum class MatrixLayouts {
+  RowMajor,  // the full matrix is stored row by row
+  TileMajor, // each block is contiguous (leading dimension = block size), the blocks are stored row by row
+};
+
+/// @brief Precision of the computation (also stored in the header of the packed files).
+enum class ScalarTypes : uint32_t {
+  Float = 0,
+  Double = 1,
+};
+
+template <typename T>
+constexpr ScalarTypes scalarType() {
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "unsupported scalar type");
+  return std::is_same_v<T, float> ? ScalarTypes::Float : ScalarTypes::Double;
+}
+
 #endif //CHOLESKY_HH_MATRIX_TYPES_H
@@ -0,0 +1,51 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_PANEL_UPDATE_DATA_H
+#define CHOLESKY_HH_PANEL_UPDATE_DATA_H
+
+#include <memory>
+#include "./matrix_block_data.h"
+#include "./tile_table.h"
+
+/// @brief Container that is used to send data to the panel update task (left looking variant):
+/// the block (i, j) receives all its updates at once, $updated = updated - \sum_k L_{ik}.L_{jk}^T$
+/// for k < j. row1 gives the decomposed blocks (i, 0..j-1) and row2 the blocks (j, 0..j-1), they are
+/// read in the tile table so the message doesn't store (and allocate) the rows.
+template <typename T>
+struct PanelUpdateData {
+  PanelUpdateData(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> updated,
+                  std::shared_ptr<TileTable<T>> tiles) :
+          updated(std::move(updated)), tiles(std::move(tiles)) {}
+
+  /// @brief Number of blocks in the rows (j).
+  [[nodiscard]] size_t size() const { return updated->x(); }
+
+  [[nodiscard]] std::shared_ptr<MatrixBlockData<T, MatrixBlock>> row1(size_t k) const {
+    return tiles->get(updated->y() * updated->nbBlocksCols() + k);
+  }
+
+  [[nodiscard]] std::shared_ptr<MatrixBlockData<T, MatrixBlock>> row2(size_t k) const {
+    return tiles->get(updated->x() * updated->nbBlocksCols() + k);
+  }
+
+  std::shared_ptr<MatrixBlockData<T, MatrixBlock>> updated = nullptr;
+  std::shared_ptr<TileTable<T>> tiles = nullptr;
+};
+
+#endif //CHOLESKY_HH_PANEL_UPDATE_DATA_H
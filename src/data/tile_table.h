@@ -0,0 +1,103 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_TILE_TABLE_H
+#define CHOLESKY_HH_TILE_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "./matrix_block_data.h"
+
+/// @brief Table of the blocks of the matrix shared by the states of the decomposition and of the
+/// solver. The state that receives a block from the split (or stream) task inserts it, the other
+/// states read it from the table instead of keeping their own copy of the block array. Each entry
+/// has a flag: the block is present, and a state watches the block (it needs a message when the
+/// block is inserted). Both are set with one atomic operation, so either the watcher sees the block
+/// or the inserter sees the watcher. The inserts are rare (once per block) and use a mutex, the
+/// reads are lock free.
+template <typename T>
+class TileTable {
+ public:
+  using Block = MatrixBlockData<T, MatrixBlock>;
+
+  TileTable() = default;
+
+  /// @brief Allocates the table, only the first call does something (all the states initialize
+  /// the table when they receive their first message).
+  void init(size_t nbBlocksRows, size_t nbBlocksCols) {
+    if (initialized_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_.load(std::memory_order_relaxed)) {
+      nbBlocksRows_ = nbBlocksRows;
+      nbBlocksCols_ = nbBlocksCols;
+      blocks_ = std::vector<std::shared_ptr<Block>>(nbBlocksRows * nbBlocksCols, nullptr);
+      flags_ = std::make_unique<std::atomic<uint8_t>[]>(nbBlocksRows * nbBlocksCols);
+      initialized_.store(true, std::memory_order_release);
+    }
+  }
+
+  [[nodiscard]] bool empty() const { return !initialized_.load(std::memory_order_acquire); }
+  [[nodiscard]] size_t size() const { return blocks_.size(); }
+  [[nodiscard]] size_t nbBlocksRows() const { return nbBlocksRows_; }
+  [[nodiscard]] size_t nbBlocksCols() const { return nbBlocksCols_; }
+
+  /// @brief Returns the block idx, or nullptr if it is not inserted yet.
+  [[nodiscard]] std::shared_ptr<Block> get(size_t idx) const {
+    if (flags_[idx].load(std::memory_order_acquire) & Present) {
+      return blocks_[idx];
+    }
+    return nullptr;
+  }
+
+  /// @brief Inserts the block if its entry is empty (the solver phases can both insert the same
+  /// block). Returns true if a state watches the block.
+  bool insert(std::shared_ptr<Block> const &block) {
+    size_t idx = block->idx();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (flags_[idx].load(std::memory_order_relaxed) & Present) {
+      return false;
+    }
+    blocks_[idx] = block;
+    return flags_[idx].fetch_or(Present, std::memory_order_acq_rel) & Watched;
+  }
+
+  /// @brief Asks for a message when the block idx is inserted. Returns false if the block is
+  /// already in the table (no message will be sent).
+  bool watch(size_t idx) {
+    return !(flags_[idx].fetch_or(Watched, std::memory_order_acq_rel) & Present);
+  }
+
+ private:
+  static constexpr uint8_t Present = 1;
+  static constexpr uint8_t Watched = 2;
+
+  std::mutex mutex_;
+  std::atomic<bool> initialized_ = false;
+  std::vector<std::shared_ptr<Block>> blocks_ = {};
+  std::unique_ptr<std::atomic<uint8_t>[]> flags_ = nullptr;
+  size_t nbBlocksRows_ = 0;
+  size_t nbBlocksCols_ = 0;
+};
+
+#endif //CHOLESKY_HH_TILE_TABLE_H
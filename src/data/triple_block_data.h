@@ -26,12 +26,15 @@ template <typename T, BlockTypes B1 = MatrixBlock, BlockTypes B2 = MatrixBlock,
 struct TripleBlockData {
   TripleBlockData(std::shared_ptr<MatrixBlockData<T, B1>> first,
                   std::shared_ptr<MatrixBlockData<T, B2>> second,
-                  std::shared_ptr<MatrixBlockData<T, B3>> third) :
-          first(first), second(second), third(third) {}
+                  std::shared_ptr<MatrixBlockData<T, B3>> third,
+                  std::shared_ptr<T[]> packedSecond = nullptr) :
+          first(first), second(second), third(third), packedSecond(std::move(packedSecond)) {}
 
   std::shared_ptr<MatrixBlockData<T, B1>> first = nullptr;
   std::shared_ptr<MatrixBlockData<T, B2>> second = nullptr;
   std::shared_ptr<MatrixBlockData<T, B3>> third = nullptr;
+  /// @brief packed copy of the second block (shared by all the updates that use it, can be nullptr)
+  std::shared_ptr<T[]> packedSecond = nullptr;
 };
 
 #endif //CHOLESKY_HH_TRIPLE_BLOCK_DATA_H
@@ -20,6 +20,7 @@
 #define CHOLESKY_DECOMPOSITION_GRAPH_H
 #include "../data/matrix_block_data.h"
 #include "../data/matrix_data.h"
+#include "../data/tile_table.h"
 #include "../state/decomposition/decompose_state.h"
 #include "../state/decomposition/decompose_state_manager.h"
 #include "../state/decomposition/update_submatrix_state.h"
@@ -28,27 +29,41 @@
 #include "../task/decomposition/compute_diagonal_block_task.h"
 #include "../task/decomposition/compute_column_block_task.h"
 #include "../task/decomposition/update_submatrix_block_task.h"
+#include "../memory/numa.h"
+#include "update_submatrix_execution_pipeline.h"
 #include <hedgehog/hedgehog.h>
 
 #define CDGraphInNb 1
 #define CDGraphIn MatrixBlockData<T, MatrixBlock>
 #define CDGraphOut MatrixBlockData<T, Decomposed>
 
-template<typename T>
+/// @brief Tile Cholesky decomposition, the tasks use the kernels of the policy Kernels (see
+/// kernels/tile_kernels.h). The states store the blocks in the tile table tiles, shared with the
+/// solver (a new table is created when it is not given).
+template<typename T, typename Kernels = GenericKernels<T>>
 class CholeskyDecompositionGraph
         : public hh::Graph<CDGraphInNb, CDGraphIn, CDGraphOut > {
  public:
   CholeskyDecompositionGraph(size_t nbThreadsComputeDiagonalTask,
       size_t nbThreadsComputeColumnTask,
-      size_t nbThreadsUpdateTask)
+      size_t nbThreadsUpdateTask,
+      std::shared_ptr<NumaPlacement> placement = nullptr,
+      size_t nbThreadsFactorDiagonal = 1,
+      size_t lookahead = 1,
+      std::shared_ptr<TileTable<T>> tiles = nullptr)
           : hh::Graph<CDGraphInNb, CDGraphIn, CDGraphOut >(
           "Cholesky Decomposition") {
-    auto decomposeState = std::make_shared<DecomposeState<T>>();
+    if (!tiles) {
+      tiles = std::make_shared<TileTable<T>>();
+    }
+    auto decomposeState = std::make_shared<DecomposeState<T>>(tiles);
     auto decomposeStateManager = std::make_shared<DecomposeStateManager<T>>(decomposeState);
-    auto computeDiagonalBlockTask = std::make_shared<ComputeDiagonalBlockTask<T>>(nbThreadsComputeDiagonalTask);
-    auto computeColumnBlockTask = std::make_shared<ComputeColumnBlockTask<T>>(nbThreadsComputeColumnTask);
-    auto updateSubMatrixBlockTask = std::make_shared<UpdateSubMatrixBlockTask<T>>(nbThreadsUpdateTask);
-    auto updateSubMatrixState = std::make_shared<UpdateSubMatrixState<T>>();
+    auto computeDiagonalBlockTask = std::make_shared<ComputeDiagonalBlockTask<T, Kernels>>(nbThreadsComputeDiagonalTask,
+                                                                                         nbThreadsFactorDiagonal);
+    auto computeColumnBlockTask = std::make_shared<ComputeColumnBlockTask<T, Kernels>>(nbThreadsComputeColumnTask, true);
+    // the state keeps 2 updates per thread in the queue of the update task and sends the others by
+    // priority, except the updates of the lookahead columns
+    auto updateSubMatrixState = std::make_shared<UpdateSubMatrixState<T>>(tiles, 2 * nbThreadsUpdateTask, lookahead);
     auto updateSubMatrixStateManager = std::make_shared<UpdateSubMatrixStateManager<T>>(
             updateSubMatrixState);
 
@@ -61,8 +76,19 @@ class CholeskyDecompositionGraph
 
     this->edges(decomposeStateManager, updateSubMatrixStateManager);
 
-    this->edges(updateSubMatrixStateManager, updateSubMatrixBlockTask);
-    this->edges(updateSubMatrixBlockTask, decomposeStateManager);
+    if (placement) {
+      // one update task per node, each one only receives the tiles placed on its node
+      auto updateSubMatrixGraph = std::make_shared<UpdateSubMatrixGraph<T, Kernels>>(
+              std::max<size_t>(1, nbThreadsUpdateTask / placement->nbNodes()), placement);
+      auto updateSubMatrixExecutionPipeline = std::make_shared<UpdateSubMatrixExecutionPipeline<T>>(
+              updateSubMatrixGraph, placement);
+      this->edges(updateSubMatrixStateManager, updateSubMatrixExecutionPipeline);
+      this->edges(updateSubMatrixExecutionPipeline, decomposeStateManager);
+    } else {
+      auto updateSubMatrixBlockTask = std::make_shared<UpdateSubMatrixBlockTask<T, Kernels>>(nbThreadsUpdateTask);
+      this->edges(updateSubMatrixStateManager, updateSubMatrixBlockTask);
+      this->edges(updateSubMatrixBlockTask, decomposeStateManager);
+    }
 
     this->outputs(decomposeStateManager);
   }
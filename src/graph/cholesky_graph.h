@@ -23,13 +23,17 @@
 #include "../data/matrix_data.h"
 #include "../data/matrix_block_data.h"
 #include "cholesky_decomposition_graph.h"
+#include "left_looking_decomposition_graph.h"
 #include "cholesky_solver_graph.h"
+#include "../task/decomposition/stream_matrix_task.h"
+#include "../task/io/write_result_task.h"
+#include "../config.h"
 
-#define CGraphInNb 2
-#define CGraphIn MatrixData<T, MatrixTypes::Matrix>, MatrixData<T, MatrixTypes::Vector>
+#define CGraphInNb 3
+#define CGraphIn MatrixData<T, MatrixTypes::Matrix>, MatrixData<T, MatrixTypes::Vector>, MatrixStreamData<T>
 #define CGraphOut MatrixBlockData<T, Result>
 
-template <typename T>
+template <typename T, typename Kernels = GenericKernels<T>>
 class CholeskyGraph
         : public hh::Graph<CGraphInNb, CGraphIn, CGraphOut > {
  public:
@@ -37,23 +41,47 @@ class CholeskyGraph
                 size_t nbThreadsComputeColumnTask,
                 size_t nbThreadsUpdateTask,
                 size_t nbThreadsSolveDiagonal,
-                size_t nbThreadsUpdateVector)
+                size_t nbThreadsUpdateVector,
+                std::shared_ptr<NumaPlacement> placement = nullptr,
+                std::shared_ptr<ResultWriter<T>> writer = nullptr,
+                Algorithms algorithm = Algorithms::RightLooking,
+                size_t nbThreadsFactorDiagonal = 1,
+                size_t lookahead = 1)
           : hh::Graph<CGraphInNb, CGraphIn, CGraphOut >("Cholesky") {
     auto splitTask = std::make_shared<SplitMatrixTask<T>>();
-    auto choleskyDecompositionGraph = std::make_shared<CholeskyDecompositionGraph<T>>(
-            nbThreadsComputeDiagonalTask,
-            nbThreadsComputeColumnTask,
-            nbThreadsUpdateTask);
+    auto streamTask = std::make_shared<StreamMatrixTask<T>>();
+    // blocks of the matrix shared by the decomposition and the solver
+    auto tiles = std::make_shared<TileTable<T>>();
+    std::shared_ptr<hh::Graph<CDGraphInNb, CDGraphIn, CDGraphOut>> choleskyDecompositionGraph = nullptr;
+    if (algorithm == Algorithms::LeftLooking) {
+      choleskyDecompositionGraph = std::make_shared<LeftLookingDecompositionGraph<T, Kernels>>(
+              nbThreadsComputeDiagonalTask,
+              nbThreadsComputeColumnTask,
+              nbThreadsUpdateTask,
+              nbThreadsFactorDiagonal,
+              tiles);
+    } else {
+      choleskyDecompositionGraph = std::make_shared<CholeskyDecompositionGraph<T, Kernels>>(
+              nbThreadsComputeDiagonalTask,
+              nbThreadsComputeColumnTask,
+              nbThreadsUpdateTask,
+              placement,
+              nbThreadsFactorDiagonal,
+              lookahead,
+              tiles);
+    }
     auto choleskySolverGraph1 =
             std::make_shared<CholeskySolverGraph<T, Phases::First>>(
-                    nbThreadsSolveDiagonal, nbThreadsUpdateVector);
+                    nbThreadsSolveDiagonal, nbThreadsUpdateVector, tiles);
     auto choleskySolverGraph2 =
             std::make_shared<CholeskySolverGraph<T, Phases::Second>>(
-                    nbThreadsSolveDiagonal, nbThreadsUpdateVector);
+                    nbThreadsSolveDiagonal, nbThreadsUpdateVector, tiles);
 
     this->inputs(splitTask);
+    this->inputs(streamTask);
 
     this->edges(splitTask, choleskyDecompositionGraph);
+    this->edges(streamTask, choleskyDecompositionGraph);
     this->edges(splitTask, choleskySolverGraph1);
 
     this->edges(choleskySolverGraph1, choleskySolverGraph2);
@@ -61,6 +89,14 @@ class CholeskyGraph
     this->edges(choleskyDecompositionGraph, choleskySolverGraph2);
 
     this->outputs(choleskySolverGraph2);
+
+    // optional sink that writes L and x in a file during the computation
+    if (writer) {
+      auto writeResultTask = std::make_shared<WriteResultTask<T>>(writer);
+
+      this->edges(choleskyDecompositionGraph, writeResultTask);
+      this->edges(choleskySolverGraph2, writeResultTask);
+    }
   }
 };
 
@@ -0,0 +1,75 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_CHOLESKY_REFINEMENT_GRAPH_H
+#define CHOLESKY_HH_CHOLESKY_REFINEMENT_GRAPH_H
+
+#include <hedgehog/hedgehog.h>
+#include <limits>
+#include "../data/matrix_data.h"
+#include "../data/matrix_block_data.h"
+#include "cholesky_solver_graph.h"
+
+#define CRGraphInNb 2
+#define CRGraphIn MatrixData<T, MatrixTypes::Matrix>, MatrixData<T, MatrixTypes::Vector>
+#define CRGraphOut MatrixBlockData<T, Result>
+
+/// @brief Solves L.L^T.x = b using a matrix that is already factorized (the input matrix contains
+/// L). It is used to compute the corrections of the iterative refinement: the matrix is pushed once
+/// and the vectors are pushed one after the other (the Result blocks of a vector are received
+/// before the next one is pushed), finishSolving is called before finishPushingData.
+template <typename T>
+class CholeskyRefinementGraph
+        : public hh::Graph<CRGraphInNb, CRGraphIn, CRGraphOut > {
+ public:
+  CholeskyRefinementGraph(size_t nbThreadsSolveDiagonal, size_t nbThreadsUpdateVector)
+          : hh::Graph<CRGraphInNb, CRGraphIn, CRGraphOut >("Cholesky Refinement") {
+    auto splitTask = std::make_shared<SplitMatrixTask<T, Decomposed>>();
+    // the blocks of L are inserted in the table by the first solver phase that receives them
+    auto tiles = std::make_shared<TileTable<T>>();
+    // the number of vectors is not known, it is given by finishSolving
+    choleskySolverGraph1_ =
+            std::make_shared<CholeskySolverGraph<T, Phases::First>>(
+                    nbThreadsSolveDiagonal, nbThreadsUpdateVector, tiles,
+                    std::numeric_limits<size_t>::max());
+    choleskySolverGraph2_ =
+            std::make_shared<CholeskySolverGraph<T, Phases::Second>>(
+                    nbThreadsSolveDiagonal, nbThreadsUpdateVector, tiles,
+                    std::numeric_limits<size_t>::max());
+
+    this->inputs(splitTask);
+
+    this->edges(splitTask, choleskySolverGraph1_);
+    this->edges(splitTask, choleskySolverGraph2_);
+    this->edges(choleskySolverGraph1_, choleskySolverGraph2_);
+
+    this->outputs(choleskySolverGraph2_);
+  }
+
+  /// @brief No more vector will be pushed (called when the vectors pushed so far are solved).
+  void finishSolving() {
+    choleskySolverGraph1_->finishSolving();
+    choleskySolverGraph2_->finishSolving();
+  }
+
+ private:
+  std::shared_ptr<CholeskySolverGraph<T, Phases::First>> choleskySolverGraph1_ = nullptr;
+  std::shared_ptr<CholeskySolverGraph<T, Phases::Second>> choleskySolverGraph2_ = nullptr;
+};
+
+#endif //CHOLESKY_HH_CHOLESKY_REFINEMENT_GRAPH_H
@@ -21,6 +21,7 @@
 
 #include "../data/matrix_block_data.h"
 #include "../data/matrix_data.h"
+#include "../data/tile_table.h"
 #include "../task/decomposition/split_matrix_task.h"
 #include "../task/solver/solve_diagonal_task.h"
 #include "../task/solver/update_vector_task.h"
@@ -39,14 +40,18 @@ template <typename T, Phases Phase>
 class CholeskySolverGraph
         : public hh::Graph<CSGraphInNb, CSGraphIn, CSGraphOut > {
  public:
-  CholeskySolverGraph(size_t nbThreadsSolveDiagonal, size_t nbThreadsUpdateVector)
+  CholeskySolverGraph(size_t nbThreadsSolveDiagonal, size_t nbThreadsUpdateVector,
+                      std::shared_ptr<TileTable<T>> tiles = nullptr, size_t nbSolves = 1)
           : hh::Graph<CSGraphInNb, CSGraphIn, CSGraphOut >(Phase == Phases::First
                                                            ? "Cholesky Solver phase 1"
                                                            : "Cholesky Solver phase 2") {
+    if (!tiles) {
+      tiles = std::make_shared<TileTable<T>>();
+    }
     auto solveDiagonalTask = std::make_shared<SolveDiagonalTask<T, Phase>>(nbThreadsSolveDiagonal);
     auto updateVectorTask = std::make_shared<UpdateVectorTask<T, Phase>>(nbThreadsUpdateVector);
-    auto solverState = std::make_shared<SolverState<T, Phase>>();
-    auto solverStateManager = std::make_shared<SolverStateManager<T, Phase>>(solverState);
+    solverState_ = std::make_shared<SolverState<T, Phase>>(tiles, nbSolves);
+    auto solverStateManager = std::make_shared<SolverStateManager<T, Phase>>(solverState_);
 
     this->inputs(solverStateManager);
 
@@ -58,6 +63,16 @@ class CholeskySolverGraph
 
     this->outputs(solverStateManager);
   }
+
+  /// @brief No more vector will be solved, the graph terminates after the current vector.
+  void finishSolving() {
+    solverState_->lock();
+    solverState_->finishSolving();
+    solverState_->unlock();
+  }
+
+ private:
+  std::shared_ptr<SolverState<T, Phase>> solverState_ = nullptr;
 };
 
 #endif
@@ -0,0 +1,67 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_LEFT_LOOKING_DECOMPOSITION_GRAPH_H
+#define CHOLESKY_HH_LEFT_LOOKING_DECOMPOSITION_GRAPH_H
+
+#include "../data/matrix_block_data.h"
+#include "../state/decomposition/left_looking_state.h"
+#include "../state/decomposition/left_looking_state_manager.h"
+#include "../task/decomposition/compute_diagonal_block_task.h"
+#include "../task/decomposition/compute_column_block_task.h"
+#include "../task/decomposition/update_panel_block_task.h"
+#include "cholesky_decomposition_graph.h"
+#include <hedgehog/hedgehog.h>
+
+/// @brief Left looking (Crout) variant of CholeskyDecompositionGraph: each block receives all its
+/// updates in one task, just before it is decomposed. Same inputs and outputs as the right looking
+/// graph, the blocks are stored in the tile table tiles.
+template<typename T, typename Kernels = GenericKernels<T>>
+class LeftLookingDecompositionGraph
+        : public hh::Graph<CDGraphInNb, CDGraphIn, CDGraphOut > {
+ public:
+  LeftLookingDecompositionGraph(size_t nbThreadsComputeDiagonalTask,
+                                size_t nbThreadsComputeColumnTask,
+                                size_t nbThreadsUpdateTask,
+                                size_t nbThreadsFactorDiagonal = 1,
+                                std::shared_ptr<TileTable<T>> tiles = nullptr)
+          : hh::Graph<CDGraphInNb, CDGraphIn, CDGraphOut >("Cholesky Left Looking Decomposition") {
+    if (!tiles) {
+      tiles = std::make_shared<TileTable<T>>();
+    }
+    auto leftLookingState = std::make_shared<LeftLookingState<T>>(tiles);
+    auto leftLookingStateManager = std::make_shared<LeftLookingStateManager<T>>(leftLookingState);
+    auto computeDiagonalBlockTask = std::make_shared<ComputeDiagonalBlockTask<T, Kernels>>(nbThreadsComputeDiagonalTask,
+                                                                                         nbThreadsFactorDiagonal);
+    auto computeColumnBlockTask = std::make_shared<ComputeColumnBlockTask<T, Kernels>>(nbThreadsComputeColumnTask);
+    auto updatePanelBlockTask = std::make_shared<UpdatePanelBlockTask<T, Kernels>>(nbThreadsUpdateTask);
+
+    this->inputs(leftLookingStateManager);
+
+    this->edges(leftLookingStateManager, computeDiagonalBlockTask);
+    this->edges(computeDiagonalBlockTask, leftLookingStateManager);
+    this->edges(leftLookingStateManager, computeColumnBlockTask);
+    this->edges(computeColumnBlockTask, leftLookingStateManager);
+    this->edges(leftLookingStateManager, updatePanelBlockTask);
+    this->edges(updatePanelBlockTask, leftLookingStateManager);
+
+    this->outputs(leftLookingStateManager);
+  }
+};
+
+#endif //CHOLESKY_HH_LEFT_LOOKING_DECOMPOSITION_GRAPH_H
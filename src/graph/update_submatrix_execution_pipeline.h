@@ -0,0 +1,69 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_UPDATE_SUBMATRIX_EXECUTION_PIPELINE_H
+#define CHOLESKY_HH_UPDATE_SUBMATRIX_EXECUTION_PIPELINE_H
+
+#include <numeric>
+#include <vector>
+#include <hedgehog/hedgehog.h>
+#include "../task/decomposition/update_submatrix_block_task.h"
+#include "../memory/numa.h"
+
+/// @brief Graph duplicated on each NUMA node by UpdateSubMatrixExecutionPipeline (one update task).
+template <typename T, typename Kernels = GenericKernels<T>>
+class UpdateSubMatrixGraph : public hh::Graph<USBTaskInNb, USBTaskIn, USBTaskOut > {
+ public:
+  UpdateSubMatrixGraph(size_t nbThreads, std::shared_ptr<NumaPlacement> placement)
+          : hh::Graph<USBTaskInNb, USBTaskIn, USBTaskOut >("Update Submatrix Graph") {
+    auto updateSubMatrixBlockTask = std::make_shared<UpdateSubMatrixBlockTask<T, Kernels>>(nbThreads, placement);
+
+    this->inputs(updateSubMatrixBlockTask);
+    this->outputs(updateSubMatrixBlockTask);
+  }
+};
+
+/// @brief One copy of the update graph per NUMA node (the device id of a copy is its node). Each
+/// triple is only sent to the copy of the node of the updated tile, so the queues of the other
+/// nodes don't see it.
+template <typename T>
+class UpdateSubMatrixExecutionPipeline
+        : public hh::AbstractExecutionPipeline<USBTaskInNb, USBTaskIn, USBTaskOut > {
+ public:
+  UpdateSubMatrixExecutionPipeline(std::shared_ptr<hh::Graph<USBTaskInNb, USBTaskIn, USBTaskOut >> const &graph,
+                                   std::shared_ptr<NumaPlacement> placement)
+          : hh::AbstractExecutionPipeline<USBTaskInNb, USBTaskIn, USBTaskOut >(
+          graph, nodeIds(placement->nbNodes()), "Update Submatrix Execution Pipeline"),
+            placement_(std::move(placement)) {}
+
+  bool sendToGraph(std::shared_ptr<UpdateSubmatrixBlockInputType<T>> &triple, size_t const &graphId) override {
+    return placement_->nodeOf(triple->third->y(), triple->third->x()) == graphId;
+  }
+
+ private:
+  std::shared_ptr<NumaPlacement> placement_ = nullptr;
+
+  static std::vector<int> nodeIds(size_t nbNodes) {
+    std::vector<int> ids(nbNodes);
+
+    std::iota(ids.begin(), ids.end(), 0);
+    return ids;
+  }
+};
+
+#endif //CHOLESKY_HH_UPDATE_SUBMATRIX_EXECUTION_PIPELINE_H
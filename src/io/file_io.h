@@ -0,0 +1,77 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_FILE_IO_H
+#define CHOLESKY_HH_FILE_IO_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+/// @brief pread wrapper that reads exactly size bytes (pread can return less).
+inline void readFully(int fd, void *buffer, size_t size, size_t offset) {
+  char *ptr = reinterpret_cast<char *>(buffer);
+
+  while (size > 0) {
+    ssize_t nb = pread(fd, ptr, size, offset);
+
+    if (nb < 0 && errno == EINTR) {
+      continue;
+    } else if (nb <= 0) {
+      throw std::runtime_error(std::string("read error: ") + (nb == 0 ? "end of file" : std::strerror(errno)));
+    }
+    ptr += nb;
+    size -= nb;
+    offset += nb;
+  }
+}
+
+/// @brief pwrite wrapper that writes exactly size bytes.
+inline void writeFully(int fd, void const *buffer, size_t size, size_t offset) {
+  char const *ptr = reinterpret_cast<char const *>(buffer);
+
+  while (size > 0) {
+    ssize_t nb = pwrite(fd, ptr, size, offset);
+
+    if (nb < 0 && errno == EINTR) {
+      continue;
+    } else if (nb < 0) {
+      throw std::runtime_error(std::string("write error: ") + std::strerror(errno));
+    }
+    ptr += nb;
+    size -= nb;
+    offset += nb;
+  }
+}
+
+/// @brief Closes the file descriptor when it goes out of scope (also when the reads throw).
+class FileDescriptorGuard {
+ public:
+  explicit FileDescriptorGuard(int fd) : fd_(fd) {}
+  FileDescriptorGuard(FileDescriptorGuard const &) = delete;
+  FileDescriptorGuard &operator=(FileDescriptorGuard const &) = delete;
+  ~FileDescriptorGuard() { close(fd_); }
+
+ private:
+  int fd_ = -1;
+};
+
+#endif //CHOLESKY_HH_FILE_IO_H
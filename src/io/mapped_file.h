@@ -0,0 +1,96 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_MAPPED_FILE_H
+#define CHOLESKY_HH_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Maps a whole file in memory. The mapping is read only by default. When copyOnWrite is
+/// set, the pages are writable but private: the modifications are never written back to the file
+/// and the kernel copies a page only when it is modified.
+class MappedFile {
+ public:
+  explicit MappedFile(std::string const &path, bool copyOnWrite = false) {
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st = {};
+
+    if (fd < 0) {
+      throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    if (fstat(fd, &st) < 0) {
+      close(fd);
+      throw std::runtime_error("cannot stat " + path + ": " + std::strerror(errno));
+    }
+    size_ = st.st_size;
+
+    if (copyOnWrite) {
+      data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    } else {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd); // the mapping keeps a reference on the file
+
+    if (data_ == MAP_FAILED) {
+      data_ = nullptr;
+      throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+    }
+  }
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  ~MappedFile() {
+    if (data_) {
+      munmap(data_, size_);
+    }
+  }
+
+  [[nodiscard]] size_t size() const { return size_; }
+
+  template <typename T>
+  [[nodiscard]] T *at(size_t offset) {
+    return reinterpret_cast<T *>(reinterpret_cast<char *>(data_) + offset);
+  }
+
+  /// @brief madvise wrapper that accepts any offset (the range is extended to the pages that
+  /// contain it).
+  void advise(size_t offset, size_t length, int advice) {
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t begin = offset - offset % pageSize;
+
+    if (begin < size_) {
+      madvise(at<char>(begin), std::min(length + offset - begin, size_ - begin), advice);
+    }
+  }
+
+ private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+#endif //CHOLESKY_HH_MAPPED_FILE_H
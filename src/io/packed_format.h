@@ -0,0 +1,227 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_PACKED_FORMAT_H
+#define CHOLESKY_HH_PACKED_FORMAT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <string>
+#include <vector>
+#include "../data/matrix_data.h"
+#include "mapped_file.h"
+
+/// Packed file format (version 1):
+/// - PackedHeader
+/// - lower triangular tiles of the input matrix
+/// - result vector
+/// - lower triangular tiles of the expected matrix (only when PackedHasExpected is set)
+/// - expected solution vector (only when PackedHasExpected is set)
+///
+/// The tiles (i, j) with j <= i are stored tile row by tile row. Each tile is stored in row major
+/// order with its real size (the tiles on the border can be smaller than blockSize) and the
+/// diagonal tiles are stored entirely.
+
+constexpr char PackedMagic[8] = {'C', 'H', 'O', 'L', 'P', 'A', 'C', 'K'};
+constexpr uint32_t PackedVersion = 1;
+constexpr uint64_t PackedHasExpected = 1;
+
+struct PackedHeader {
+  char magic[8] = {};
+  uint32_t version = PackedVersion;
+  uint32_t scalarType = 0;
+  uint64_t size = 0;      // the matrix is size x size
+  uint64_t blockSize = 0; // size of the tiles used to order the file
+  uint64_t flags = 0;
+  uint64_t reserved[3] = {}; // keeps the data aligned on 64 bytes
+};
+
+static_assert(sizeof(PackedHeader) == 64);
+
+/// @brief Position of the tiles of a packed lower triangular matrix (in number of elements).
+struct PackedLayout {
+  PackedLayout(size_t size, size_t blockSize)
+          : size(size), blockSize(blockSize), nbBlocks(size / blockSize + (size % blockSize ? 1 : 0)) {}
+
+  [[nodiscard]] size_t tileHeight(size_t i) const { return std::min(blockSize, size - i * blockSize); }
+  [[nodiscard]] size_t tileWidth(size_t j) const { return tileHeight(j); }
+
+  /// @brief All the tile rows before i are full, so the offset only depends on i and j.
+  [[nodiscard]] size_t tileOffset(size_t i, size_t j) const {
+    return blockSize * blockSize * (i * (i + 1) / 2) + j * tileHeight(i) * blockSize;
+  }
+
+  [[nodiscard]] size_t tileRowOffset(size_t i) const { return tileOffset(i, 0); }
+
+  /// @brief number of elements in the tile row i
+  [[nodiscard]] size_t tileRowSize(size_t i) const { return tileHeight(i) * std::min(size, (i + 1) * blockSize); }
+
+  [[nodiscard]] size_t nbElements() const { return tileRowOffset(nbBlocks - 1) + tileRowSize(nbBlocks - 1); }
+
+  size_t size;
+  size_t blockSize;
+  size_t nbBlocks;
+};
+
+/// @brief Byte offsets of the different parts of a packed file.
+template <typename T>
+struct PackedFileOffsets {
+  explicit PackedFileOffsets(PackedHeader const &header)
+          : layout(header.size, header.blockSize) {
+    matrix = sizeof(PackedHeader);
+    result = matrix + layout.nbElements() * sizeof(T);
+    expectedMatrix = result + header.size * sizeof(T);
+    expectedSolution = expectedMatrix + layout.nbElements() * sizeof(T);
+    end = (header.flags & PackedHasExpected) ? expectedSolution + header.size * sizeof(T)
+                                             : expectedMatrix;
+  }
+
+  PackedLayout layout;
+  size_t matrix;
+  size_t result;
+  size_t expectedMatrix;
+  size_t expectedSolution;
+  size_t end;
+};
+
+inline bool isPackedFile(MappedFile &file) {
+  return file.size() >= sizeof(PackedHeader)
+         && std::memcmp(file.at<PackedHeader>(0)->magic, PackedMagic, sizeof(PackedMagic)) == 0;
+}
+
+/// @brief Validates the header of a packed file and returns it.
+template <typename T>
+PackedHeader readPackedHeader(MappedFile &file, std::string const &name) {
+  PackedHeader header = *file.at<PackedHeader>(0);
+
+  if (header.version != PackedVersion) {
+    throw std::runtime_error("unsupported packed file version in " + name);
+  }
+  if (header.scalarType != (uint32_t) scalarType<T>()) {
+    throw std::runtime_error("scalar type mismatch in " + name);
+  }
+  if (header.size == 0 || header.blockSize == 0 || file.size() < PackedFileOffsets<T>(header).end) {
+    throw std::runtime_error("invalid packed file " + name);
+  }
+  return header;
+}
+
+/// @brief Copies the packed tile row i (packedRow points on its first tile) in the row major matrix.
+template <typename T>
+void unpackTileRow(PackedLayout const &layout, size_t i, T const *packedRow,
+                   MatrixData<T, MatrixTypes::Matrix> &matrix) {
+  for (size_t j = 0; j <= i; ++j) {
+    T const *tile = packedRow + layout.tileOffset(i, j) - layout.tileRowOffset(i);
+    size_t height = layout.tileHeight(i);
+    size_t width = layout.tileWidth(j);
+
+    if (matrix.layout() == MatrixLayouts::RowMajor || matrix.blockSize() == layout.blockSize) {
+      T *block = matrix.get() + matrix.index(i * layout.blockSize, j * layout.blockSize);
+
+      for (size_t r = 0; r < height; ++r) {
+        std::memcpy(block + r * matrix.blockLd(), tile + r * width, width * sizeof(T));
+      }
+    } else {
+      // the tiles of the file don't match the blocks of the matrix
+      for (size_t r = 0; r < height; ++r) {
+        for (size_t c = 0; c < width; ++c) {
+          matrix.get()[matrix.index(i * layout.blockSize + r, j * layout.blockSize + c)] = tile[r * width + c];
+        }
+      }
+    }
+  }
+}
+
+/// @brief Copies the packed lower triangular tiles in the row major matrix.
+template <typename T>
+void unpackLower(PackedLayout const &layout, T const *packed, MatrixData<T, MatrixTypes::Matrix> &matrix) {
+  for (size_t i = 0; i < layout.nbBlocks; ++i) {
+    unpackTileRow(layout, i, packed + layout.tileRowOffset(i), matrix);
+  }
+}
+
+/// @brief Writes the lower triangular tiles of a matrix (converted to FileT).
+template <typename FileT, typename T>
+void writePackedLower(std::ostream &os, PackedLayout const &layout, MatrixData<T, MatrixTypes::Matrix> &matrix) {
+  std::vector<FileT> tile;
+
+  for (size_t i = 0; i < layout.nbBlocks; ++i) {
+    for (size_t j = 0; j <= i; ++j) {
+      size_t height = layout.tileHeight(i);
+      size_t width = layout.tileWidth(j);
+
+      tile.resize(height * width);
+      for (size_t r = 0; r < height; ++r) {
+        for (size_t c = 0; c < width; ++c) {
+          tile[r * width + c] = matrix.at(i * layout.blockSize + r, j * layout.blockSize + c);
+        }
+      }
+      os.write(reinterpret_cast<char *>(tile.data()), tile.size() * sizeof(FileT));
+    }
+  }
+}
+
+/// @brief Writes a vector (converted to FileT).
+template <typename FileT, typename T>
+void writePackedVector(std::ostream &os, MatrixData<T, MatrixTypes::Vector> &vector) {
+  std::vector<FileT> values(vector.get(), vector.get() + vector.height());
+
+  os.write(reinterpret_cast<char *>(values.data()), values.size() * sizeof(FileT));
+}
+
+/// @brief Writes a problem in the packed format, the values are stored with the scalar type FileT.
+/// The expected values are optional.
+template <typename T, typename FileT = T>
+void writePacked(std::string const &fileName, size_t blockSize,
+                 MatrixData<T, MatrixTypes::Matrix> &matrix, MatrixData<T, MatrixTypes::Vector> &result,
+                 MatrixData<T, MatrixTypes::Matrix> *expectedMatrix = nullptr,
+                 MatrixData<T, MatrixTypes::Vector> *expectedSolution = nullptr) {
+  std::ofstream fs(fileName, std::ios::binary);
+  PackedHeader header;
+  PackedLayout layout(matrix.height(), blockSize);
+
+  if (!fs) {
+    throw std::runtime_error("cannot open " + fileName);
+  }
+
+  std::memcpy(header.magic, PackedMagic, sizeof(PackedMagic));
+  header.scalarType = (uint32_t) scalarType<FileT>();
+  header.size = matrix.height();
+  header.blockSize = blockSize;
+  header.flags = (expectedMatrix && expectedSolution) ? PackedHasExpected : 0;
+  fs.write(reinterpret_cast<char *>(&header), sizeof(header));
+
+  writePackedLower<FileT>(fs, layout, matrix);
+  writePackedVector<FileT>(fs, result);
+
+  if (header.flags & PackedHasExpected) {
+    writePackedLower<FileT>(fs, layout, *expectedMatrix);
+    writePackedVector<FileT>(fs, *expectedSolution);
+  }
+
+  if (!fs) {
+    throw std::runtime_error("error while writing " + fileName);
+  }
+}
+
+#endif //CHOLESKY_HH_PACKED_FORMAT_H
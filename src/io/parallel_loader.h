@@ -0,0 +1,119 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_PARALLEL_LOADER_H
+#define CHOLESKY_HH_PARALLEL_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "file_io.h"
+#include "../data/matrix_data.h"
+#include "../memory/numa.h"
+
+/// @brief Byte range of the file read for one task of the loader.
+struct FileRange {
+  size_t offset;
+  size_t size;
+};
+
+/// @brief Runs fn(i) for i in [0, n) on a pool of threads, the indices are distributed dynamically.
+/// On NUMA machines the threads are spread over the nodes, so the pages first touched by fn are
+/// distributed over the nodes as well. The first exception thrown by fn is rethrown.
+template <typename Func>
+void parallelFor(size_t n, Func &&fn, size_t nbThreads = std::thread::hardware_concurrency()) {
+  NumaTopology topology;
+  std::atomic<size_t> next = 0;
+  std::exception_ptr error = nullptr;
+  std::mutex errorMutex;
+  std::vector<std::thread> threads;
+
+  nbThreads = std::clamp<size_t>(nbThreads, 1, std::max<size_t>(n, 1));
+  for (size_t t = 0; t < nbThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      if (topology.nbNodes() > 1) {
+        topology.bindCurrentThread(t % topology.nbNodes());
+      }
+      try {
+        for (size_t i = next++; i < n; i = next++) {
+          fn(i);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = n; // stop the other threads
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/// @brief Reads n ranges of the file (rangeOf(i) gives the range i) with a pool of threads using
+/// pread, and calls process(i, buffer) on each of them from the thread that read it. The ranges
+/// are aligned on tile rows by the callers, so the threads don't write to the same tiles.
+template <typename T, typename Range, typename Process>
+void parallelRead(std::string const &fileName, size_t n, Range &&rangeOf, Process &&process) {
+  int fd = open(fileName.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    throw std::runtime_error("cannot open " + fileName);
+  }
+  FileDescriptorGuard guard(fd);
+
+  parallelFor(n, [&](size_t i) {
+    static thread_local std::vector<T> buffer;
+    FileRange range = rangeOf(i);
+
+    buffer.resize(range.size / sizeof(T));
+    readFully(fd, buffer.data(), range.size, range.offset);
+    process(i, buffer.data());
+  });
+}
+
+/// @brief Copies the blocks (0..lastBlock) of the row major tile row i in the matrix (any layout).
+template <typename T>
+void copyTileRow(MatrixData<T, MatrixTypes::Matrix> &matrix, size_t iBlock, T const *tileRow,
+                 size_t lastBlock) {
+  size_t height = std::min(matrix.blockSize(), matrix.height() - iBlock * matrix.blockSize());
+
+  for (size_t jBlock = 0; jBlock <= lastBlock; ++jBlock) {
+    size_t width = std::min(matrix.blockSize(), matrix.width() - jBlock * matrix.blockSize());
+    T *block = matrix.blockPtr(iBlock, jBlock);
+
+    for (size_t r = 0; r < height; ++r) {
+      std::copy(tileRow + r * matrix.width() + jBlock * matrix.blockSize(),
+                tileRow + r * matrix.width() + jBlock * matrix.blockSize() + width,
+                block + r * matrix.blockLd());
+    }
+  }
+}
+
+#endif //CHOLESKY_HH_PARALLEL_LOADER_H
@@ -0,0 +1,98 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_RESULT_WRITER_H
+#define CHOLESKY_HH_RESULT_WRITER_H
+
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "file_io.h"
+#include "packed_format.h"
+
+/// @brief Writes the results in a packed file (see packed_format.h) while they are computed: the
+/// matrix part of the file contains the factor L and the vector part contains the solution x. The
+/// tiles and the vector blocks are written at their final position with pwrite, so the writer
+/// can be used by several threads.
+template <typename T>
+class ResultWriter {
+ public:
+  ResultWriter(std::string const &fileName, size_t size, size_t blockSize)
+          : fileName_(fileName), offsets_(makeHeader(size, blockSize)) {
+    PackedHeader header = makeHeader(size, blockSize);
+
+    fd_ = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      throw std::runtime_error("cannot create " + fileName + ": " + std::strerror(errno));
+    }
+    writeFully(fd_, &header, sizeof(header), 0);
+    if (ftruncate(fd_, offsets_.end) < 0) {
+      close(fd_);
+      throw std::runtime_error("cannot resize " + fileName + ": " + std::strerror(errno));
+    }
+  }
+
+  ResultWriter(ResultWriter const &) = delete;
+  ResultWriter &operator=(ResultWriter const &) = delete;
+
+  ~ResultWriter() {
+    close(fd_);
+  }
+
+  [[nodiscard]] std::string const &fileName() const { return fileName_; }
+
+  /// @brief Writes the tile (i, j) of L, the upper part of the diagonal tiles is set to 0.
+  void writeTile(size_t i, size_t j, T const *ptr, size_t ld) {
+    static thread_local std::vector<T> tile;
+    PackedLayout const &layout = offsets_.layout;
+    size_t height = layout.tileHeight(i);
+    size_t width = layout.tileWidth(j);
+
+    tile.resize(height * width);
+    for (size_t r = 0; r < height; ++r) {
+      for (size_t c = 0; c < width; ++c) {
+        tile[r * width + c] = (i == j && c > r) ? 0 : ptr[r * ld + c];
+      }
+    }
+    writeFully(fd_, tile.data(), tile.size() * sizeof(T),
+               offsets_.matrix + layout.tileOffset(i, j) * sizeof(T));
+  }
+
+  /// @brief Writes the block i of the solution.
+  void writeVector(size_t i, T const *ptr, size_t height) {
+    writeFully(fd_, ptr, height * sizeof(T), offsets_.result + i * offsets_.layout.blockSize * sizeof(T));
+  }
+
+ private:
+  std::string fileName_;
+  PackedFileOffsets<T> offsets_;
+  int fd_ = -1;
+
+  static PackedHeader makeHeader(size_t size, size_t blockSize) {
+    PackedHeader header;
+
+    std::memcpy(header.magic, PackedMagic, sizeof(PackedMagic));
+    header.scalarType = (uint32_t) scalarType<T>();
+    header.size = size;
+    header.blockSize = blockSize;
+    return header;
+  }
+};
+
+#endif //CHOLESKY_HH_RESULT_WRITER_H
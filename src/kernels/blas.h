@@ -0,0 +1,97 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_BLAS_H
+#define CHOLESKY_HH_BLAS_H
+
+#include <cblas.h>
+#include <lapack.h>
+#include <cstdint>
+
+/// Overloads of the BLAS / LAPACK routines used by the tasks, so the tasks can be written for any
+/// scalar type (float calls the s* routines and double calls the d* routines). The matrices are
+/// row major.
+namespace blas {
+
+inline int32_t potrf(int32_t n, double *a, int32_t lda) {
+  int32_t info = 0;
+  LAPACK_dpotrf((char *) "U", &n, a, &lda, &info);
+  return info;
+}
+
+inline int32_t potrf(int32_t n, float *a, int32_t lda) {
+  int32_t info = 0;
+  LAPACK_spotrf((char *) "U", &n, a, &lda, &info);
+  return info;
+}
+
+inline void trsm(CBLAS_SIDE side, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, CBLAS_DIAG diag,
+                 int32_t m, int32_t n, double alpha, double const *a, int32_t lda, double *b, int32_t ldb) {
+  cblas_dtrsm(CblasRowMajor, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb);
+}
+
+inline void trsm(CBLAS_SIDE side, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, CBLAS_DIAG diag,
+                 int32_t m, int32_t n, float alpha, float const *a, int32_t lda, float *b, int32_t ldb) {
+  cblas_strsm(CblasRowMajor, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb);
+}
+
+inline void gemm(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int32_t m, int32_t n, int32_t k,
+                 double alpha, double const *a, int32_t lda, double const *b, int32_t ldb,
+                 double beta, double *c, int32_t ldc) {
+  cblas_dgemm(CblasRowMajor, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void gemm(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB, int32_t m, int32_t n, int32_t k,
+                 float alpha, float const *a, int32_t lda, float const *b, int32_t ldb,
+                 float beta, float *c, int32_t ldc) {
+  cblas_sgemm(CblasRowMajor, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+/// @brief C = alpha.A.A^T + beta.C, only the lower part of C is computed.
+inline void syrk(int32_t n, int32_t k, double alpha, double const *a, int32_t lda, double beta,
+                 double *c, int32_t ldc) {
+  cblas_dsyrk(CblasRowMajor, CblasLower, CblasNoTrans, n, k, alpha, a, lda, beta, c, ldc);
+}
+
+inline void syrk(int32_t n, int32_t k, float alpha, float const *a, int32_t lda, float beta,
+                 float *c, int32_t ldc) {
+  cblas_ssyrk(CblasRowMajor, CblasLower, CblasNoTrans, n, k, alpha, a, lda, beta, c, ldc);
+}
+
+/// @brief y = alpha.A.x + beta.y where A is symmetric (only the lower part is read).
+inline void symv(int32_t n, double alpha, double const *a, int32_t lda, double const *x,
+                 double beta, double *y) {
+  cblas_dsymv(CblasRowMajor, CblasLower, n, alpha, a, lda, x, 1, beta, y, 1);
+}
+
+inline void symv(int32_t n, float alpha, float const *a, int32_t lda, float const *x,
+                 float beta, float *y) {
+  cblas_ssymv(CblasRowMajor, CblasLower, n, alpha, a, lda, x, 1, beta, y, 1);
+}
+
+inline double nrm2(int32_t n, double const *x) {
+  return cblas_dnrm2(n, x, 1);
+}
+
+inline float nrm2(int32_t n, float const *x) {
+  return cblas_snrm2(n, x, 1);
+}
+
+}
+
+#endif //CHOLESKY_HH_BLAS_H
@@ -0,0 +1,163 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_PARALLEL_POTRF_H
+#define CHOLESKY_HH_PARALLEL_POTRF_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Small group of threads that stays alive between the calls of parallelFor (a diagonal
+/// block is factorized by a few fork-joins, creating the threads for each of them would cost more
+/// than the computation). The calling thread is part of the group, the others sleep between the
+/// calls.
+class ThreadGroup {
+ public:
+  explicit ThreadGroup(size_t nbThreads) {
+    for (size_t t = 1; t < nbThreads; ++t) {
+      workers_.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~ThreadGroup() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ThreadGroup(ThreadGroup const &) = delete;
+  ThreadGroup &operator=(ThreadGroup const &) = delete;
+
+  [[nodiscard]] size_t nbThreads() const { return workers_.size() + 1; }
+
+  /// @brief Runs fn(i) for i in [0, n) on the threads of the group, the indices are distributed
+  /// dynamically. Returns when all the calls are done.
+  void parallelFor(size_t n, std::function<void(size_t)> const &fn) {
+    if (workers_.empty() || n <= 1) {
+      for (size_t i = 0; i < n; ++i) {
+        fn(i);
+      }
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &fn;
+      n_ = n;
+      next_ = 0;
+      nbRunning_ = workers_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    runJob();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return nbRunning_ == 0; });
+    job_ = nullptr;
+  }
+
+ private:
+  std::vector<std::thread> workers_ = {};
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::function<void(size_t)> const *job_ = nullptr;
+  size_t n_ = 0;
+  std::atomic<size_t> next_ = 0;
+  size_t nbRunning_ = 0;
+  size_t generation_ = 0;
+  bool stop_ = false;
+
+  void runJob() {
+    for (size_t i = next_++; i < n_; i = next_++) {
+      (*job_)(i);
+    }
+  }
+
+  void work() {
+    size_t generation = 0;
+
+    while (true) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      lock.unlock();
+      runJob();
+      lock.lock();
+      if (--nbRunning_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+};
+
+/// @brief The recursion of parallelPotrf stops on the blocks smaller than this size, which are
+/// factorized by Kernels::potrf on the calling thread.
+constexpr size_t ParallelPotrfLeaf = 128;
+
+/// @brief Recursive blocked Cholesky factorization of the lower part of A (n x n, row major)
+/// computed on a group of threads:
+///   A11 = L11.L11^T (recursive), L21 = A21.L11^-T, A22 = A22 - L21.L21^T, A22 = L22.L22^T (recursive)
+/// The trsm and the update of A22 are split by rows between the threads of the group. Returns the
+/// same info as potrf (0 or the order of the first minor that is not positive definite).
+template <typename Kernels, typename T>
+int32_t parallelPotrf(size_t n, T *a, size_t lda, ThreadGroup &group) {
+  if (n <= ParallelPotrfLeaf) {
+    return Kernels::potrf(n, a, lda);
+  }
+  size_t n1 = std::max<size_t>(1, n / 2 / ParallelPotrfLeaf) * ParallelPotrfLeaf;
+  size_t n2 = n - n1;
+  T *a21 = a + n1 * lda;
+  T *a22 = a21 + n1;
+  // two chunks per thread so the threads that get the cheap rows of A22 can take another chunk
+  size_t nbRows = (n2 + 2 * group.nbThreads() - 1) / (2 * group.nbThreads());
+  size_t nbChunks = (n2 + nbRows - 1) / nbRows;
+
+  if (int32_t info = parallelPotrf<Kernels>(n1, a, lda, group)) {
+    return info;
+  }
+  group.parallelFor(nbChunks, [&](size_t chunk) {
+    size_t row = chunk * nbRows;
+    Kernels::trsm(std::min(nbRows, n2 - row), n1, a, lda, a21 + row * lda, lda);
+  });
+  group.parallelFor(nbChunks, [&](size_t chunk) {
+    size_t row = chunk * nbRows;
+    size_t m = std::min(nbRows, n2 - row);
+    if (row > 0) {
+      Kernels::gemm(m, row, n1, a21 + row * lda, lda, a21, lda, a22 + row * lda, lda);
+    }
+    Kernels::syrk(m, n1, a21 + row * lda, lda, a22 + row * lda + row, lda);
+  });
+  int32_t info = parallelPotrf<Kernels>(n2, a22, lda, group);
+  return info ? info + (int32_t) n1 : 0;
+}
+
+#endif //CHOLESKY_HH_PARALLEL_POTRF_H
@@ -0,0 +1,360 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_SMALL_KERNELS_H
+#define CHOLESKY_HH_SMALL_KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/// Kernels used for the small tiles, where the overhead of the BLAS calls (argument checks,
+/// dispatch, packing) dominates the computation. All the kernels are written with dot products of
+/// contiguous rows (row major matrices), which are vectorized with AVX2 or AVX-512. The instruction
+/// set is detected at runtime, so the program doesn't need to be compiled with -mavx2.
+///
+/// The tasks use these kernels for the tiles smaller than SMALL_TILE_THRESHOLD.
+
+#ifndef SMALL_TILE_THRESHOLD
+#define SMALL_TILE_THRESHOLD 64
+#endif
+
+namespace small {
+
+constexpr size_t Threshold = SMALL_TILE_THRESHOLD;
+
+/* dot products ***************************************************************/
+
+template <typename T>
+struct SimdKernels {
+  T (*dot)(T const *x, T const *y, size_t n);
+  void (*dot4)(T const *x, T const *y, size_t ldy, size_t n, T *out); // x.y_0 ... x.y_3
+};
+
+template <typename T>
+T dotScalar(T const *x, T const *y, size_t n) {
+  T sum = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+template <typename T>
+void dot4Scalar(T const *x, T const *y, size_t ldy, size_t n, T *out) {
+  for (size_t j = 0; j < 4; ++j) {
+    out[j] = dotScalar(x, y + j * ldy, n);
+  }
+}
+
+#if defined(__x86_64__)
+
+/* AVX2 */
+
+__attribute__((target("avx2,fma"))) inline double hsumAvx2(__m256d v) {
+  __m128d low = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+__attribute__((target("avx2,fma"))) inline float hsumAvx2(__m256 v) {
+  __m128 low = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  low = _mm_hadd_ps(low, low);
+  return _mm_cvtss_f32(_mm_hadd_ps(low, low));
+}
+
+__attribute__((target("avx2,fma"))) inline double dotAvx2(double const *x, double const *y, size_t n) {
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+  }
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+  }
+  double sum = hsumAvx2(_mm256_add_pd(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) inline float dotAvx2(float const *x, float const *y, size_t n) {
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+  }
+  float sum = hsumAvx2(_mm256_add_ps(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) inline void dot4Avx2(double const *x, double const *y, size_t ldy,
+                                                          size_t n, double *out) {
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d xi = _mm256_loadu_pd(x + i);
+    acc0 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(y + i), acc0);
+    acc1 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(y + ldy + i), acc1);
+    acc2 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(y + 2 * ldy + i), acc2);
+    acc3 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(y + 3 * ldy + i), acc3);
+  }
+  out[0] = hsumAvx2(acc0);
+  out[1] = hsumAvx2(acc1);
+  out[2] = hsumAvx2(acc2);
+  out[3] = hsumAvx2(acc3);
+  for (; i < n; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      out[j] += x[i] * y[j * ldy + i];
+    }
+  }
+}
+
+__attribute__((target("avx2,fma"))) inline void dot4Avx2(float const *x, float const *y, size_t ldy,
+                                                          size_t n, float *out) {
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 xi = _mm256_loadu_ps(x + i);
+    acc0 = _mm256_fmadd_ps(xi, _mm256_loadu_ps(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(xi, _mm256_loadu_ps(y + ldy + i), acc1);
+    acc2 = _mm256_fmadd_ps(xi, _mm256_loadu_ps(y + 2 * ldy + i), acc2);
+    acc3 = _mm256_fmadd_ps(xi, _mm256_loadu_ps(y + 3 * ldy + i), acc3);
+  }
+  out[0] = hsumAvx2(acc0);
+  out[1] = hsumAvx2(acc1);
+  out[2] = hsumAvx2(acc2);
+  out[3] = hsumAvx2(acc3);
+  for (; i < n; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      out[j] += x[i] * y[j * ldy + i];
+    }
+  }
+}
+
+/* AVX-512 (the tails are handled with masked loads) */
+
+// _mm512_reduce_add_* and the 512 to 256 bits casts extract from an undefined register, which gcc 12
+// reports as uninitialized with -O3, so the halves are extracted with a zero mask instead.
+
+__attribute__((target("avx512f"))) inline double hsumAvx512(__m512d v) {
+  __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xff, v, 0),
+                               _mm512_maskz_extractf64x4_pd(0xff, v, 1));
+  __m128d low = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+__attribute__((target("avx512f"))) inline float hsumAvx512(__m512 v) {
+  __m512d w = _mm512_castps_pd(v);
+  __m256 half = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, w, 0)),
+                              _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, w, 1)));
+  __m128 low = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+  low = _mm_add_ps(low, _mm_movehl_ps(low, low));
+  return _mm_cvtss_f32(_mm_add_ss(low, _mm_shuffle_ps(low, low, 1)));
+}
+
+__attribute__((target("avx512f"))) inline double dotAvx512(double const *x, double const *y, size_t n) {
+  __m512d acc = _mm512_setzero_pd();
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc);
+  }
+  if (i < n) {
+    __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+    acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), acc);
+  }
+  return hsumAvx512(acc);
+}
+
+__attribute__((target("avx512f"))) inline float dotAvx512(float const *x, float const *y, size_t n) {
+  __m512 acc = _mm512_setzero_ps();
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc);
+  }
+  if (i < n) {
+    __mmask16 mask = (__mmask16) ((1u << (n - i)) - 1);
+    acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), acc);
+  }
+  return hsumAvx512(acc);
+}
+
+__attribute__((target("avx512f"))) inline void dot4Avx512(double const *x, double const *y, size_t ldy,
+                                                           size_t n, double *out) {
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+
+  for (size_t i = 0; i < n; i += 8) {
+    __mmask8 mask = n - i >= 8 ? (__mmask8) 0xff : (__mmask8) ((1u << (n - i)) - 1);
+    __m512d xi = _mm512_maskz_loadu_pd(mask, x + i);
+    acc0 = _mm512_fmadd_pd(xi, _mm512_maskz_loadu_pd(mask, y + i), acc0);
+    acc1 = _mm512_fmadd_pd(xi, _mm512_maskz_loadu_pd(mask, y + ldy + i), acc1);
+    acc2 = _mm512_fmadd_pd(xi, _mm512_maskz_loadu_pd(mask, y + 2 * ldy + i), acc2);
+    acc3 = _mm512_fmadd_pd(xi, _mm512_maskz_loadu_pd(mask, y + 3 * ldy + i), acc3);
+  }
+  out[0] = hsumAvx512(acc0);
+  out[1] = hsumAvx512(acc1);
+  out[2] = hsumAvx512(acc2);
+  out[3] = hsumAvx512(acc3);
+}
+
+__attribute__((target("avx512f"))) inline void dot4Avx512(float const *x, float const *y, size_t ldy,
+                                                           size_t n, float *out) {
+  __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+  __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 mask = n - i >= 16 ? (__mmask16) 0xffff : (__mmask16) ((1u << (n - i)) - 1);
+    __m512 xi = _mm512_maskz_loadu_ps(mask, x + i);
+    acc0 = _mm512_fmadd_ps(xi, _mm512_maskz_loadu_ps(mask, y + i), acc0);
+    acc1 = _mm512_fmadd_ps(xi, _mm512_maskz_loadu_ps(mask, y + ldy + i), acc1);
+    acc2 = _mm512_fmadd_ps(xi, _mm512_maskz_loadu_ps(mask, y + 2 * ldy + i), acc2);
+    acc3 = _mm512_fmadd_ps(xi, _mm512_maskz_loadu_ps(mask, y + 3 * ldy + i), acc3);
+  }
+  out[0] = hsumAvx512(acc0);
+  out[1] = hsumAvx512(acc1);
+  out[2] = hsumAvx512(acc2);
+  out[3] = hsumAvx512(acc3);
+}
+
+#endif
+
+/// @brief Selects the best implementation supported by the cpu.
+template <typename T>
+SimdKernels<T> selectSimdKernels() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return {dotAvx512, dot4Avx512};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {dotAvx2, dot4Avx2};
+  }
+#endif
+  return {dotScalar<T>, dot4Scalar<T>};
+}
+
+template <typename T>
+SimdKernels<T> const &simd() {
+  static SimdKernels<T> const kernels = selectSimdKernels<T>();
+  return kernels;
+}
+
+/* kernels ********************************************************************/
+
+/// @brief C = C - A.B^T (A is m x k, B is n x k and C is m x n).
+template <typename T>
+void gemm(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb, T *c, size_t ldc) {
+  auto const &kernels = simd<T>();
+  T sums[4];
+
+  for (size_t i = 0; i < m; ++i) {
+    size_t j = 0;
+
+    for (; j + 4 <= n; j += 4) {
+      kernels.dot4(a + i * lda, b + j * ldb, ldb, k, sums);
+      for (size_t jj = 0; jj < 4; ++jj) {
+        c[i * ldc + j + jj] -= sums[jj];
+      }
+    }
+    for (; j < n; ++j) {
+      c[i * ldc + j] -= kernels.dot(a + i * lda, b + j * ldb, k);
+    }
+  }
+}
+
+/// @brief C = C - A.A^T, only the lower part of C is computed (A is n x k and C is n x n).
+template <typename T>
+void syrk(size_t n, size_t k, T const *a, size_t lda, T *c, size_t ldc) {
+  auto const &kernels = simd<T>();
+  T sums[4];
+
+  for (size_t i = 0; i < n; ++i) {
+    size_t j = 0;
+
+    for (; j + 4 <= i + 1; j += 4) {
+      kernels.dot4(a + i * lda, a + j * lda, lda, k, sums);
+      for (size_t jj = 0; jj < 4; ++jj) {
+        c[i * ldc + j + jj] -= sums[jj];
+      }
+    }
+    for (; j <= i; ++j) {
+      c[i * ldc + j] -= kernels.dot(a + i * lda, a + j * lda, k);
+    }
+  }
+}
+
+/// @brief B = B.L^-T where L is lower triangular (B is m x n and L is n x n).
+template <typename T>
+void trsm(size_t m, size_t n, T const *l, size_t ldl, T *b, size_t ldb) {
+  auto const &kernels = simd<T>();
+
+  for (size_t i = 0; i < m; ++i) {
+    T *row = b + i * ldb;
+
+    for (size_t j = 0; j < n; ++j) {
+      row[j] = (row[j] - kernels.dot(row, l + j * ldl, j)) / l[j * ldl + j];
+    }
+  }
+}
+
+/// @brief A = L.L^T, the lower part of A is replaced by L (the upper part is not used). Returns 0
+/// or the index (starting at 1) of the first non positive pivot, like potrf.
+template <typename T>
+int32_t potrf(size_t n, T *a, size_t lda) {
+  auto const &kernels = simd<T>();
+
+  for (size_t j = 0; j < n; ++j) {
+    T *rowJ = a + j * lda;
+    T pivot = rowJ[j] - kernels.dot(rowJ, rowJ, j);
+
+    if (!(pivot > 0)) {
+      return (int32_t) j + 1;
+    }
+    rowJ[j] = std::sqrt(pivot);
+    for (size_t i = j + 1; i < n; ++i) {
+      T *rowI = a + i * lda;
+      rowI[j] = (rowI[j] - kernels.dot(rowI, rowJ, j)) / rowJ[j];
+    }
+  }
+  return 0;
+}
+
+}
+
+#endif //CHOLESKY_HH_SMALL_KERNELS_H
@@ -0,0 +1,460 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_TILE_KERNELS_H
+#define CHOLESKY_HH_TILE_KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "blas.h"
+#include "small_kernels.h"
+
+/// Kernel policies of the decomposition tasks. A policy provides the three kernels of the
+/// decomposition on row major tiles:
+/// - potrf(n, a, lda): A = L.L^T, the lower part of A is replaced by L,
+/// - trsm(m, n, l, ldl, b, ldb): B = B.L^-T,
+/// - gemm(m, n, k, a, lda, b, ldb, c, ldc): C = C - A.B^T,
+/// - syrk(n, k, a, lda, c, ldc): C = C - A.A^T, only the lower part of C is computed,
+/// - pack(n, k, b, ldb) and gemmPacked(..., b, ldb, panels, c, ldc): gemm where B was packed once
+///   (the column blocks are used by many updates).
+///
+/// GenericKernels works for any tile size (small kernels or BLAS). TileKernels<T, B> is specialized
+/// for the full B x B tiles: the loop bounds are known at compile time, so the loops are fully
+/// vectorized without remainders. The tiles on the edges of the matrix (smaller than B) use the
+/// generic kernels. The policy is chosen at startup from the block size with withTileKernels.
+///
+/// The specialized kernels beat the small kernels and BLAS up to 64 x 64 tiles, above BLAS (which
+/// packs and blocks for the caches) is faster, so by default the tiles larger than FIXED_TILE_MAX use
+/// the generic kernels. cholesky-benchmark-kernels compares both policies for each size.
+
+#ifndef FIXED_TILE_MAX
+#define FIXED_TILE_MAX 64
+#endif
+
+/// @brief Kernels for any tile size: the small kernels below SMALL_TILE_THRESHOLD and BLAS above.
+template <typename T>
+struct GenericKernels {
+  static constexpr size_t BlockSize = 0;
+
+  static int32_t potrf(size_t n, T *a, size_t lda) {
+    if (n < small::Threshold) {
+      return small::potrf(n, a, lda);
+    }
+    return blas::potrf((int32_t) n, a, (int32_t) lda);
+  }
+
+  static void trsm(size_t m, size_t n, T const *l, size_t ldl, T *b, size_t ldb) {
+    if (n < small::Threshold) {
+      small::trsm(m, n, l, ldl, b, ldb);
+    } else {
+      blas::trsm(CblasRight, CblasLower, CblasTrans, CblasNonUnit, (int32_t) m, (int32_t) n, T(1),
+                 l, (int32_t) ldl, b, (int32_t) ldb);
+    }
+  }
+
+  static void gemm(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb,
+                   T *c, size_t ldc) {
+    if (k < small::Threshold) {
+      small::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    } else {
+      blas::gemm(CblasNoTrans, CblasTrans, (int32_t) m, (int32_t) n, (int32_t) k, T(-1), a,
+                 (int32_t) lda, b, (int32_t) ldb, T(1), c, (int32_t) ldc);
+    }
+  }
+
+  /// @brief Packed copy of B (n x k) for gemmPacked: BLAS has no interface to reuse packed
+  /// operands, so nothing is packed.
+  static std::shared_ptr<T[]> pack(size_t, size_t, T const *, size_t) { return nullptr; }
+
+  static void gemmPacked(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb,
+                         T const *, T *c, size_t ldc) {
+    gemm(m, n, k, a, lda, b, ldb, c, ldc);
+  }
+
+  static void syrk(size_t n, size_t k, T const *a, size_t lda, T *c, size_t ldc) {
+    if (k < small::Threshold) {
+      small::syrk(n, k, a, lda, c, ldc);
+    } else {
+      blas::syrk((int32_t) n, (int32_t) k, T(-1), a, (int32_t) lda, T(1), c, (int32_t) ldc);
+    }
+  }
+};
+
+namespace fixed {
+
+/* bodies *********************************************************************/
+
+// The bodies are inlined in the functions compiled for each instruction set below. The inner loops
+// always run on contiguous rows, the operand that would be read by column is transposed first in a
+// per thread buffer.
+
+template <typename T, size_t B>
+T *transposeBuffer() {
+  static thread_local std::vector<T> buffer(B * B);
+  return buffer.data();
+}
+
+/// @brief 64 bytes of values (gcc vector extension, one AVX-512 register or two AVX2 registers).
+template <typename T>
+struct VectorType;
+
+template <>
+struct VectorType<double> {
+  typedef double type __attribute__((vector_size(64)));
+};
+
+template <>
+struct VectorType<float> {
+  typedef float type __attribute__((vector_size(64)));
+};
+
+template <typename T>
+using Vector = typename VectorType<T>::type;
+
+template <typename T>
+constexpr size_t VectorWidth = 64 / sizeof(T);
+
+// the vectors are passed by reference: returning them by value changes the ABI without AVX-512
+template <typename T>
+[[gnu::always_inline]] inline void load(Vector<T> &vector, T const *data) {
+  __builtin_memcpy(&vector, data, sizeof(vector));
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void store(T *data, Vector<T> const &vector) {
+  __builtin_memcpy(data, &vector, sizeof(vector));
+}
+
+/// @brief Packs B (B x B) by panels of 64 bytes wide columns of B^T: the panel p holds the
+/// values B(p.Width + jj, q) at q.Width + jj. This is the operand format of gemmPackedBody.
+template <typename T, size_t B>
+[[gnu::always_inline]] inline void packBody(T const *b, size_t ldb, T *panels) {
+  constexpr size_t Width = VectorWidth<T>;
+
+  for (size_t j = 0; j < B; ++j) {
+    T *panel = panels + (j / Width) * B * Width + j % Width;
+    for (size_t q = 0; q < B; ++q) {
+      panel[q * Width] = b[j * ldb + q];
+    }
+  }
+}
+
+/// @brief C = C - A.B^T where B is packed (packBody), computed by blocks of Rows rows x 64 bytes of
+/// C, which are accumulated in registers (4 rows with AVX2 where a vector uses 2 registers, 8 rows
+/// with AVX-512). The panel used for a column block of C stays in the L1 cache while all the rows
+/// of A are processed. With Lower (syrk, B = A), the blocks above the diagonal are skipped and only
+/// the lower part of C is written.
+template <typename T, size_t B, size_t Rows, bool Lower = false>
+[[gnu::always_inline]] inline void gemmPackedBody(T const *a, size_t lda, T const *panels, T *c,
+                                                  size_t ldc) {
+  constexpr size_t Width = VectorWidth<T>;
+  static_assert(B % Rows == 0 && B % Width == 0);
+
+  for (size_t j = 0; j < B; j += Width) {
+    T const *panel = panels + j * B;
+
+    for (size_t i = Lower ? j / Rows * Rows : 0; i < B; i += Rows) {
+      Vector<T> sums[Rows] = {};
+
+      for (size_t q = 0; q < B; ++q) {
+        Vector<T> bq;
+        load(bq, panel + q * Width);
+        for (size_t r = 0; r < Rows; ++r) {
+          sums[r] += a[(i + r) * lda + q] * bq;
+        }
+      }
+      for (size_t r = 0; r < Rows; ++r) {
+        T *row = c + (i + r) * ldc + j;
+
+        if (!Lower || i + r >= j + Width - 1) {
+          Vector<T> values;
+          load(values, row);
+          store(row, values - sums[r]);
+        } else {
+          for (size_t jj = 0; j + jj <= i + r; ++jj) {
+            row[jj] -= sums[r][jj];
+          }
+        }
+      }
+    }
+  }
+}
+
+/// @brief C = C - A.B^T, B is packed in a per thread buffer first.
+template <typename T, size_t B, size_t Rows, bool Lower = false>
+[[gnu::always_inline]] inline void gemmBody(T const *a, size_t lda, T const *b, size_t ldb, T *c,
+                                            size_t ldc) {
+  T *panels = transposeBuffer<T, B>();
+
+  packBody<T, B>(b, ldb, panels);
+  gemmPackedBody<T, B, Rows, Lower>(a, lda, panels, c, ldc);
+}
+
+/// @brief B = B.L^-T: each row x of the result solves L.x^T = b^T (forward substitution done with
+/// the columns of L, so with the rows of L^T).
+template <typename T, size_t B>
+[[gnu::always_inline]] inline void trsmBody(T const *l, size_t ldl, T *b, size_t ldb) {
+  T *lt = transposeBuffer<T, B>();
+  T inverses[B];
+
+  for (size_t j = 0; j < B; ++j) {
+    for (size_t q = 0; q <= j; ++q) {
+      lt[q * B + j] = l[j * ldl + q];
+    }
+    inverses[j] = T(1) / l[j * ldl + j];
+  }
+  for (size_t i = 0; i < B; ++i) {
+    T *row = b + i * ldb;
+
+    for (size_t q = 0; q < B; ++q) {
+      T x = row[q] * inverses[q];
+      T const *ltq = lt + q * B;
+
+      row[q] = x;
+      for (size_t j = q + 1; j < B; ++j) {
+        row[j] -= ltq[j] * x;
+      }
+    }
+  }
+}
+
+/// @brief A = L.L^T computed as A = U^T.U with U = L^T (the rows of U are contiguous). Returns 0 or
+/// the index (starting at 1) of the first non positive pivot.
+template <typename T, size_t B>
+[[gnu::always_inline]] inline int32_t potrfBody(T *a, size_t lda) {
+  T *u = transposeBuffer<T, B>();
+  int32_t info = 0;
+
+  for (size_t i = 0; i < B; ++i) {
+    for (size_t j = 0; j <= i; ++j) {
+      u[j * B + i] = a[i * lda + j];
+    }
+  }
+  for (size_t k = 0; k < B; ++k) {
+    T *uk = u + k * B;
+
+    if (!(uk[k] > 0)) {
+      info = (int32_t) k + 1;
+      break;
+    }
+    uk[k] = std::sqrt(uk[k]);
+    T inverse = T(1) / uk[k];
+    for (size_t j = k + 1; j < B; ++j) {
+      uk[j] *= inverse;
+    }
+    for (size_t i = k + 1; i < B; ++i) {
+      T *ui = u + i * B;
+      T factor = uk[i];
+
+      for (size_t j = i; j < B; ++j) {
+        ui[j] -= factor * uk[j];
+      }
+    }
+  }
+  for (size_t i = 0; i < B; ++i) {
+    for (size_t j = 0; j <= i; ++j) {
+      a[i * lda + j] = u[j * B + i];
+    }
+  }
+  return info;
+}
+
+/* instruction sets ***********************************************************/
+
+template <typename T, size_t B>
+struct Kernels {
+  int32_t (*potrf)(T *a, size_t lda);
+  void (*trsm)(T const *l, size_t ldl, T *b, size_t ldb);
+  void (*gemm)(T const *a, size_t lda, T const *b, size_t ldb, T *c, size_t ldc);
+  void (*syrk)(T const *a, size_t lda, T *c, size_t ldc);
+  void (*gemmPacked)(T const *a, size_t lda, T const *panels, T *c, size_t ldc);
+};
+
+template <typename T, size_t B>
+int32_t potrfDefault(T *a, size_t lda) { return potrfBody<T, B>(a, lda); }
+template <typename T, size_t B>
+void trsmDefault(T const *l, size_t ldl, T *b, size_t ldb) { trsmBody<T, B>(l, ldl, b, ldb); }
+template <typename T, size_t B>
+void gemmDefault(T const *a, size_t lda, T const *b, size_t ldb, T *c, size_t ldc) {
+  gemmBody<T, B, 4>(a, lda, b, ldb, c, ldc);
+}
+template <typename T, size_t B>
+void syrkDefault(T const *a, size_t lda, T *c, size_t ldc) {
+  gemmBody<T, B, 4, true>(a, lda, a, lda, c, ldc);
+}
+template <typename T, size_t B>
+void gemmPackedDefault(T const *a, size_t lda, T const *panels, T *c, size_t ldc) {
+  gemmPackedBody<T, B, 4>(a, lda, panels, c, ldc);
+}
+
+#if defined(__x86_64__)
+
+template <typename T, size_t B>
+__attribute__((target("avx2,fma"))) int32_t potrfAvx2(T *a, size_t lda) {
+  return potrfBody<T, B>(a, lda);
+}
+template <typename T, size_t B>
+__attribute__((target("avx2,fma"))) void trsmAvx2(T const *l, size_t ldl, T *b, size_t ldb) {
+  trsmBody<T, B>(l, ldl, b, ldb);
+}
+template <typename T, size_t B>
+__attribute__((target("avx2,fma"))) void gemmAvx2(T const *a, size_t lda, T const *b, size_t ldb,
+                                                  T *c, size_t ldc) {
+  gemmBody<T, B, 4>(a, lda, b, ldb, c, ldc);
+}
+template <typename T, size_t B>
+__attribute__((target("avx2,fma"))) void syrkAvx2(T const *a, size_t lda, T *c, size_t ldc) {
+  gemmBody<T, B, 4, true>(a, lda, a, lda, c, ldc);
+}
+template <typename T, size_t B>
+__attribute__((target("avx2,fma"))) void gemmPackedAvx2(T const *a, size_t lda, T const *panels, T *c,
+                                                        size_t ldc) {
+  gemmPackedBody<T, B, 4>(a, lda, panels, c, ldc);
+}
+
+template <typename T, size_t B>
+__attribute__((target("avx512f"))) int32_t potrfAvx512(T *a, size_t lda) {
+  return potrfBody<T, B>(a, lda);
+}
+template <typename T, size_t B>
+__attribute__((target("avx512f"))) void trsmAvx512(T const *l, size_t ldl, T *b, size_t ldb) {
+  trsmBody<T, B>(l, ldl, b, ldb);
+}
+template <typename T, size_t B>
+__attribute__((target("avx512f"))) void gemmAvx512(T const *a, size_t lda, T const *b, size_t ldb,
+                                                   T *c, size_t ldc) {
+  gemmBody<T, B, 8>(a, lda, b, ldb, c, ldc);
+}
+template <typename T, size_t B>
+__attribute__((target("avx512f"))) void syrkAvx512(T const *a, size_t lda, T *c, size_t ldc) {
+  gemmBody<T, B, 8, true>(a, lda, a, lda, c, ldc);
+}
+template <typename T, size_t B>
+__attribute__((target("avx512f"))) void gemmPackedAvx512(T const *a, size_t lda, T const *panels, T *c,
+                                                         size_t ldc) {
+  gemmPackedBody<T, B, 8>(a, lda, panels, c, ldc);
+}
+
+#endif
+
+/// @brief Selects the best implementation supported by the cpu (like small::selectSimdKernels).
+template <typename T, size_t B>
+Kernels<T, B> selectKernels() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return {potrfAvx512<T, B>, trsmAvx512<T, B>, gemmAvx512<T, B>, syrkAvx512<T, B>,
+            gemmPackedAvx512<T, B>};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {potrfAvx2<T, B>, trsmAvx2<T, B>, gemmAvx2<T, B>, syrkAvx2<T, B>,
+            gemmPackedAvx2<T, B>};
+  }
+#endif
+  return {potrfDefault<T, B>, trsmDefault<T, B>, gemmDefault<T, B>, syrkDefault<T, B>,
+          gemmPackedDefault<T, B>};
+}
+
+template <typename T, size_t B>
+Kernels<T, B> const &kernels() {
+  static Kernels<T, B> const kernels = selectKernels<T, B>();
+  return kernels;
+}
+
+}
+
+/// @brief Kernels specialized for the B x B tiles, the other tiles use the generic kernels.
+template <typename T, size_t B>
+struct TileKernels {
+  static constexpr size_t BlockSize = B;
+
+  static int32_t potrf(size_t n, T *a, size_t lda) {
+    if (n != B) {
+      return GenericKernels<T>::potrf(n, a, lda);
+    }
+    return fixed::kernels<T, B>().potrf(a, lda);
+  }
+
+  static void trsm(size_t m, size_t n, T const *l, size_t ldl, T *b, size_t ldb) {
+    if (m != B || n != B) {
+      GenericKernels<T>::trsm(m, n, l, ldl, b, ldb);
+    } else {
+      fixed::kernels<T, B>().trsm(l, ldl, b, ldb);
+    }
+  }
+
+  static void gemm(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb,
+                   T *c, size_t ldc) {
+    if (m != B || n != B || k != B) {
+      GenericKernels<T>::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    } else {
+      fixed::kernels<T, B>().gemm(a, lda, b, ldb, c, ldc);
+    }
+  }
+
+  /// @brief Packed copy of the full tiles B (n x k) for gemmPacked, nullptr for the other tiles.
+  static std::shared_ptr<T[]> pack(size_t n, size_t k, T const *b, size_t ldb) {
+    if (n != B || k != B) {
+      return nullptr;
+    }
+    std::shared_ptr<T[]> panels(new T[B * B]);
+    fixed::packBody<T, B>(b, ldb, panels.get());
+    return panels;
+  }
+
+  /// @brief gemm where B can be given packed (pack), which avoids to pack it for each call.
+  static void gemmPacked(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb,
+                         T const *panels, T *c, size_t ldc) {
+    if (!panels || m != B || n != B || k != B) {
+      gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    } else {
+      fixed::kernels<T, B>().gemmPacked(a, lda, panels, c, ldc);
+    }
+  }
+
+  static void syrk(size_t n, size_t k, T const *a, size_t lda, T *c, size_t ldc) {
+    if (n != B || k != B) {
+      GenericKernels<T>::syrk(n, k, a, lda, c, ldc);
+    } else {
+      fixed::kernels<T, B>().syrk(a, lda, c, ldc);
+    }
+  }
+};
+
+/// @brief Calls function with the kernel policy of the block size: TileKernels<T, B> when B is one
+/// of the specialized sizes up to FIXED_TILE_MAX, GenericKernels<T> otherwise.
+template <typename T, typename Function>
+void withTileKernels(size_t blockSize, Function &&function) {
+  switch (blockSize) {
+    case 16: function(TileKernels<T, 16>{}); return;
+    case 32: function(TileKernels<T, 32>{}); return;
+    case 64: function(TileKernels<T, 64>{}); return;
+#if FIXED_TILE_MAX >= 128
+    case 128: function(TileKernels<T, 128>{}); return;
+#endif
+#if FIXED_TILE_MAX >= 256
+    case 256: function(TileKernels<T, 256>{}); return;
+#endif
+    default: function(GenericKernels<T>{}); return;
+  }
+}
+
+#endif //CHOLESKY_HH_TILE_KERNELS_H
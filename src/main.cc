@@ -20,6 +20,8 @@
 #include "data/matrix_types.h"
 #include "graph/cholesky_graph.h"
 #include "utils.h"
+#include "refinement.h"
+#include "tuning.h"
 #include "config.h"
 #include <cblas.h>
 #include <iostream>
@@ -28,8 +30,6 @@
 #include <vector>
 #define NB_MEASURES 10
 
-using MatrixType = double;
-
 /******************************************************************************/
 /* threads config                                                             */
 /******************************************************************************/
@@ -50,22 +50,41 @@ void initThreadsConfig() {
 /* run the algorithm                                                          */
 /******************************************************************************/
 
-void cholesky(Config const &config,
-              std::shared_ptr<MatrixData<MatrixType, MatrixTypes::Matrix>> &matrix,
-              std::shared_ptr<MatrixData<MatrixType, MatrixTypes::Vector>> &result) {
-  CholeskyGraph<MatrixType> choleskyGraph(
+template <typename T, typename Kernels>
+void cholesky(Config const &config, Problem<T> &problem) {
+  auto &matrix = problem.matrix;
+  auto &result = problem.result;
+  std::shared_ptr<ResultWriter<T>> writer = nullptr;
+
+  if (config.algorithm == Algorithms::LeftLooking && matrix->cache()) {
+    throw std::runtime_error("the left looking variant requires the matrix in memory (no out-of-core mode)");
+  }
+  if (!config.outputFile.empty()) {
+    writer = std::make_shared<ResultWriter<T>>(config.outputFile, matrix->height(), matrix->blockSize());
+  }
+
+  CholeskyGraph<T, Kernels> choleskyGraph(
           config.threadsConfig.nbThreadsComputeDiagonalTask,
           config.threadsConfig.nbThreadsComputeColumnTask,
           config.threadsConfig.nbThreadsUpdateTask,
           config.threadsConfig.nbThreadsSolveDiagonal,
-          config.threadsConfig.nbThreadsUpdateVector);
+          config.threadsConfig.nbThreadsUpdateVector,
+          makeNumaPlacement(config.numa),
+          writer,
+          config.algorithm,
+          config.threadsConfig.nbThreadsFactorDiagonal,
+          config.lookahead);
   choleskyGraph.executeGraph(true);
 
   /* launch the graph */
 
   auto begin = std::chrono::system_clock::now();
 
-  choleskyGraph.pushData(matrix);
+  if (problem.stream) {
+    choleskyGraph.pushData(problem.stream); // the matrix is read by the graph
+  } else {
+    choleskyGraph.pushData(matrix);
+  }
   choleskyGraph.pushData(result);
   choleskyGraph.finishPushingData();
   choleskyGraph.waitForTermination();
@@ -87,6 +106,84 @@ void cholesky(Config const &config,
   }
 }
 
+/// @brief Runs the algorithm with the kernels specialized for the block size (see
+/// kernels/tile_kernels.h).
+template <typename T>
+void cholesky(Config const &config, Problem<T> &problem) {
+  withTileKernels<T>(problem.matrix->blockSize(), [&]<typename Kernels>(Kernels) {
+    cholesky<T, Kernels>(config, problem);
+  });
+}
+
+/// @brief Loads the problem and runs the algorithm with the scalar type T.
+template <typename T>
+void run(Config &config) {
+  auto problem = initMatrix<T>(config); // matrix allocated
+  initThreadsConfig();
+
+  // the out-of-core decomposition overwrites the input tiles, so it runs only once
+  if (config.loop && config.tileFile.empty()) {
+    for (auto threadsConfig : threadsConfigs) {
+      for (size_t nbMeasures = 0; nbMeasures < NB_MEASURES; ++nbMeasures) {
+        config.threadsConfig = threadsConfig;
+        cholesky(config, problem);
+        verifySolution(problem, T(1e-3));
+        if (!problem.stream) {
+          problem.matrix->reset(problem.baseMatrix);
+        }
+        problem.result->reset(problem.baseResult);
+      }
+    }
+  } else {
+    cholesky(config, problem);
+    syncOutOfCore(problem);
+    verifySolution(problem, T(1e-3));
+  }
+
+  print(config, problem);
+
+  free(problem); // matrix freed
+}
+
+/// @brief Mixed precision: the matrix is factorized in float with the tile graph, then the solution
+/// is refined in double using the original matrix (saved matrix of the problem).
+void runMixed(Config config) {
+  auto problem = initMatrix<double>(config);
+
+  if (!problem.baseMatrix || !problem.matrix->get()) {
+    throw std::runtime_error("the mixed precision mode requires the matrix in memory (no streaming or "
+                             "out-of-core mode with packed files)");
+  }
+  size_t size = problem.matrix->height();
+  Arena arena(ArenaSize<float>()
+                      .add(MatrixData<float>::bufferSize(size, size, config.blockSize, config.layout))
+                      .add(size).size(),
+              config.hugePages);
+  auto factor = std::make_shared<MatrixData<float, MatrixTypes::Matrix>>(
+          size, size, config.blockSize, arena, config.layout);
+  auto correction = std::make_shared<MatrixData<float, MatrixTypes::Vector>>(1, size, config.blockSize, arena);
+  Problem<float> single(factor, correction, nullptr, nullptr);
+
+  convertLower(*problem.baseMatrix, *factor);
+  for (size_t i = 0; i < size; ++i) {
+    correction->get()[i] = (float) problem.baseResult->get()[i];
+  }
+  config.outputFile = ""; // the output file would contain the unrefined solution
+  cholesky(config, single);
+
+  // first solution given by the float factorization
+  for (size_t i = 0; i < size; ++i) {
+    problem.result->get()[i] = correction->get()[i];
+  }
+  refineSolution(config, *problem.baseMatrix, *problem.baseResult, factor, correction, *problem.result);
+
+  // the decomposition is verified with the float factor
+  convertLower(*factor, *problem.matrix);
+  verifySolution(problem, 1e-3);
+  print(config, problem);
+  free(problem);
+}
+
 /******************************************************************************/
 /* main                                                                       */
 /******************************************************************************/
@@ -98,32 +195,35 @@ int main(int argc, char **argv) {
           .blockSize = 10,
           .print = false,
           .loop = false,
+          .stream = false,
+          .layout = MatrixLayouts::RowMajor,
+          .hugePages = false,
+          .numa = NumaPlacements::None,
+          .tileFile = "",
+          .cacheSize = 1024,
+          .outputFile = "",
+          .precision = Precisions::Double,
+          .refinementSteps = 10,
+          .algorithm = Algorithms::RightLooking,
+          .lookahead = 1,
+          .autotune = false,
+          .tuningFile = "cholesky-hh.tuning",
           .threadsConfig = ThreadsConfig()
   };
 
   openblas_set_num_threads(1);
   parseCmdArgs(argc, argv, config);
+  if (config.autotune) {
+    config.blockSize = autotuneBlockSize(config);
+    std::cerr << "autotune: block size " << config.blockSize << " (" << config.tuningFile << ")" << std::endl;
+  }
 
-  auto problem = initMatrix<MatrixType>(config); // matrix allocated
-  initThreadsConfig();
-
-  if (config.loop) {
-    for (auto threadsConfig : threadsConfigs) {
-      for (size_t nbMeasures = 0; nbMeasures < NB_MEASURES; ++nbMeasures) {
-        config.threadsConfig = threadsConfig;
-        cholesky(config, problem.matrix, problem.result);
-        verifySolution(problem, 1e-3);
-        problem.matrix->reset(problem.baseMatrix);
-        problem.result->reset(problem.baseResult);
-      }
-    }
+  if (config.precision == Precisions::Float) {
+    run<float>(config);
+  } else if (config.precision == Precisions::Mixed) {
+    runMixed(config);
   } else {
-    cholesky(config, problem.matrix, problem.result);
-    verifySolution(problem, 1e-3);
+    run<double>(config);
   }
-
-  print(config, problem);
-
-  free(problem); // matrix freed
   return 0;
 }
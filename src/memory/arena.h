@@ -0,0 +1,112 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_ARENA_H
+#define CHOLESKY_HH_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+
+/// @brief Single anonymous mapping from which the big buffers of the program are allocated. The
+/// returned regions are aligned on 64 bytes and are not initialized (the pages are zeroed by the
+/// kernel on first touch only). The memory is released when the arena is destroyed.
+///
+/// When hugePages is set, the arena tries to use explicit 2MB pages (MAP_HUGETLB, requires
+/// reserved huge pages) and falls back to transparent huge pages (MADV_HUGEPAGE).
+class Arena {
+ public:
+  static constexpr size_t Alignment = 64;
+  static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+  explicit Arena(size_t capacity, bool hugePages = false) {
+    capacity_ = roundUp(capacity == 0 ? 1 : capacity, hugePages ? HugePageSize : Alignment);
+
+    // no MAP_NORESERVE here: the mapping must fail if there are not enough huge pages (the
+    // process would be killed on first touch otherwise)
+    if (hugePages) {
+      data_ = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (!hugePages || data_ == MAP_FAILED) {
+      data_ = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (data_ != MAP_FAILED && hugePages) {
+        madvise(data_, capacity_, MADV_HUGEPAGE);
+      }
+    }
+    if (data_ == MAP_FAILED) {
+      data_ = nullptr;
+      throw std::bad_alloc();
+    }
+  }
+
+  Arena(Arena const &) = delete;
+  Arena &operator=(Arena const &) = delete;
+
+  ~Arena() {
+    if (data_) {
+      munmap(data_, capacity_);
+    }
+  }
+
+  /// @brief Allocates a buffer of nbElements elements (not initialized).
+  template <typename T>
+  T *allocate(size_t nbElements) {
+    size_t size = alignedSize(nbElements * sizeof(T));
+
+    if (size > capacity_ - used_) {
+      throw std::bad_alloc();
+    }
+    T *ptr = reinterpret_cast<T *>(reinterpret_cast<char *>(data_) + used_);
+    used_ += size;
+    return ptr;
+  }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+  [[nodiscard]] size_t used() const { return used_; }
+
+  /// @brief Size taken in the arena by an allocation of size bytes.
+  static size_t alignedSize(size_t size) { return roundUp(size, Alignment); }
+
+ private:
+  void *data_ = nullptr;
+  size_t capacity_ = 0;
+  size_t used_ = 0;
+
+  static size_t roundUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+};
+
+/// @brief Computes the capacity of an arena that contains the given buffers of T.
+template <typename T>
+class ArenaSize {
+ public:
+  ArenaSize &add(size_t nbElements) {
+    size_ += Arena::alignedSize(nbElements * sizeof(T));
+    return *this;
+  }
+
+  [[nodiscard]] size_t size() const { return size_; }
+
+ private:
+  size_t size_ = 0;
+};
+
+#endif //CHOLESKY_HH_ARENA_H
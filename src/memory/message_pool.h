@@ -0,0 +1,163 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_MESSAGE_POOL_H
+#define CHOLESKY_HH_MESSAGE_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/// @brief Recycles the memory of the messages sent between the tasks and the states (blocks, triples,
+/// ...). A message is allocated with its shared_ptr control block by makeMessage, and the memory is
+/// returned to the pool of its size when the last reference is dropped. The messages are created by
+/// one thread and freed by another (the receiving task), so each thread keeps a cache of free nodes
+/// and exchanges batches of nodes with a global lock-free list. After the first columns, the
+/// messages don't allocate anymore.
+template <size_t Size, size_t Align>
+class FixedSizePool {
+  static_assert(Size >= sizeof(void *), "the free nodes store the next node");
+
+ public:
+  static constexpr size_t Batch = 64; // number of nodes given to the global list at once
+
+  static void *allocate() {
+    auto &free = cache().free;
+
+    if (free.empty()) {
+      global().take(free);
+      if (free.empty()) {
+        return ::operator new(Size, std::align_val_t(Align));
+      }
+    }
+    void *node = free.back();
+    free.pop_back();
+    return node;
+  }
+
+  static void deallocate(void *node) {
+    auto &free = cache().free;
+
+    free.push_back(node);
+    if (free.size() >= 2 * Batch) {
+      global().give(free, Batch);
+    }
+  }
+
+ private:
+  /// @brief Free nodes shared by the threads, linked through their first bytes (Treiber stack).
+  /// The batches are pushed with a compare and swap, and a thread takes the whole list with an
+  /// exchange, so the list never reads the next node of a node that another thread may own (no ABA
+  /// problem).
+  struct Global {
+    std::atomic<void *> head = nullptr;
+
+    void take(std::vector<void *> &to) {
+      for (void *node = head.exchange(nullptr, std::memory_order_acquire); node; node = next(node)) {
+        to.push_back(node);
+      }
+    }
+
+    void give(std::vector<void *> &from, size_t nb) {
+      if (nb == 0) {
+        return;
+      }
+      void *first = from[from.size() - nb];
+      void *last = from.back();
+
+      for (size_t i = from.size() - nb; i + 1 < from.size(); ++i) {
+        next(from[i]) = from[i + 1];
+      }
+      from.resize(from.size() - nb);
+      next(last) = head.load(std::memory_order_relaxed);
+      while (!head.compare_exchange_weak(next(last), first, std::memory_order_release,
+                                         std::memory_order_relaxed)) {}
+    }
+
+    ~Global() {
+      void *node = head.load(std::memory_order_acquire);
+
+      while (node) {
+        void *nextNode = next(node);
+        ::operator delete(node, std::align_val_t(Align));
+        node = nextNode;
+      }
+    }
+
+    static void *&next(void *node) { return *static_cast<void **>(node); }
+  };
+
+  /// @brief Free nodes of a thread, returned to the global list when the thread terminates.
+  struct Cache {
+    std::vector<void *> free;
+
+    Cache() { global(); } // the global list is destroyed after the cache of the main thread
+
+    ~Cache() { global().give(free, free.size()); }
+  };
+
+  static Global &global() {
+    static Global global;
+    return global;
+  }
+
+  static Cache &cache() {
+    thread_local Cache cache;
+    return cache;
+  }
+};
+
+/// @brief Allocator of the messages, the single objects come from the pool of their size (the
+/// control block and the message in the case of allocate_shared).
+template <typename T>
+struct MessageAllocator {
+  using value_type = T;
+
+  MessageAllocator() = default;
+
+  template <typename U>
+  MessageAllocator(MessageAllocator<U> const &) {}
+
+  T *allocate(size_t n) {
+    if (n == 1) {
+      return static_cast<T *>(FixedSizePool<sizeof(T), alignof(T)>::allocate());
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+  }
+
+  void deallocate(T *ptr, size_t n) {
+    if (n == 1) {
+      FixedSizePool<sizeof(T), alignof(T)>::deallocate(ptr);
+    } else {
+      ::operator delete(ptr, std::align_val_t(alignof(T)));
+    }
+  }
+
+  template <typename U>
+  bool operator==(MessageAllocator<U> const &) const { return true; }
+};
+
+/// @brief Replaces std::make_shared for the messages sent at each step of the computation.
+template <typename T, typename ...Args>
+std::shared_ptr<T> makeMessage(Args &&...args) {
+  return std::allocate_shared<T>(MessageAllocator<T>(), std::forward<Args>(args)...);
+}
+
+#endif //CHOLESKY_HH_MESSAGE_POOL_H
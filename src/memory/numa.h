@@ -0,0 +1,169 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_NUMA_H
+#define CHOLESKY_HH_NUMA_H
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include "../data/matrix_data.h"
+#include "numa_placements.h"
+
+/// @brief NUMA nodes of the machine and their cpus (read from sysfs, no dependency on libnuma).
+class NumaTopology {
+ public:
+  NumaTopology() {
+    for (size_t node = 0;; ++node) {
+      std::ifstream fs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string cpuList;
+
+      if (!fs || !std::getline(fs, cpuList)) {
+        break;
+      }
+      cpus_.push_back(parseCpuList(cpuList));
+    }
+  }
+
+  [[nodiscard]] size_t nbNodes() const { return cpus_.size(); }
+  [[nodiscard]] std::vector<size_t> const &cpus(size_t node) const { return cpus_[node]; }
+
+  /// @brief Pins the calling thread on the cpus of the node.
+  void bindCurrentThread(size_t node) const {
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    for (size_t cpu : cpus_[node]) {
+      CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+
+ private:
+  std::vector<std::vector<size_t>> cpus_ = {};
+
+  /// @brief parses lists like "0-3,8-11"
+  static std::vector<size_t> parseCpuList(std::string const &cpuList) {
+    std::vector<size_t> cpus;
+    std::istringstream iss(cpuList);
+    std::string range;
+
+    while (std::getline(iss, range, ',')) {
+      if (range.empty()) {
+        continue;
+      }
+      size_t sep = range.find('-');
+      size_t first = std::stoul(range.substr(0, sep));
+      size_t last = sep == std::string::npos ? first : std::stoul(range.substr(sep + 1));
+
+      for (size_t cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+};
+
+/// @brief Gives the node on which each tile of the matrix is placed.
+class NumaPlacement {
+ public:
+  NumaPlacement(NumaPlacements mode, NumaTopology topology)
+          : mode_(mode), topology_(std::move(topology)) {
+    size_t nbNodes = topology_.nbNodes();
+
+    // grid of nodes as square as possible for the block cyclic distribution
+    gridRows_ = 1;
+    for (size_t p = 1; p * p <= nbNodes; ++p) {
+      if (nbNodes % p == 0) {
+        gridRows_ = nbNodes / p;
+      }
+    }
+    gridCols_ = nbNodes / gridRows_;
+  }
+
+  [[nodiscard]] size_t nbNodes() const { return topology_.nbNodes(); }
+  [[nodiscard]] NumaTopology const &topology() const { return topology_; }
+
+  [[nodiscard]] size_t nodeOf(size_t iBlock, size_t jBlock) const {
+    if (mode_ == NumaPlacements::BlockCyclic) {
+      return (iBlock % gridRows_) * gridCols_ + jBlock % gridCols_;
+    }
+    // index of the tile in the lower triangular part
+    return (iBlock * (iBlock + 1) / 2 + jBlock) % nbNodes();
+  }
+
+  /// @brief Touches the tiles of the matrix from threads bound to their node so the pages are
+  /// allocated on it (first-touch policy). It has to be done before anything is written in the
+  /// buffer. The tiles share pages in the row major layout, so the placement is only exact with
+  /// the tile major layout.
+  template <typename T>
+  void place(MatrixData<T, MatrixTypes::Matrix> &matrix) const {
+    std::vector<std::thread> threads;
+
+    for (size_t node = 0; node < nbNodes(); ++node) {
+      threads.emplace_back([this, node, &matrix]() {
+        topology_.bindCurrentThread(node);
+        for (size_t iBlock = 0; iBlock < matrix.nbBlocksRows(); ++iBlock) {
+          for (size_t jBlock = 0; jBlock < matrix.nbBlocksCols(); ++jBlock) {
+            if (nodeOf(iBlock, jBlock) == node) {
+              touchBlock(matrix, iBlock, jBlock);
+            }
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  NumaPlacements mode_ = NumaPlacements::None;
+  NumaTopology topology_;
+  size_t gridRows_ = 1;
+  size_t gridCols_ = 1;
+
+  template <typename T>
+  static void touchBlock(MatrixData<T, MatrixTypes::Matrix> &matrix, size_t iBlock, size_t jBlock) {
+    size_t height = std::min(matrix.blockSize(), matrix.height() - iBlock * matrix.blockSize());
+    size_t width = std::min(matrix.blockSize(), matrix.width() - jBlock * matrix.blockSize());
+    T *block = matrix.blockPtr(iBlock, jBlock);
+
+    for (size_t r = 0; r < height; ++r) {
+      std::fill(block + r * matrix.blockLd(), block + r * matrix.blockLd() + width, 0);
+    }
+  }
+};
+
+/// @brief Returns nullptr when the placement is not needed (single node or no placement).
+inline std::shared_ptr<NumaPlacement> makeNumaPlacement(NumaPlacements mode) {
+  NumaTopology topology;
+
+  if (mode == NumaPlacements::None || topology.nbNodes() <= 1) {
+    return nullptr;
+  }
+  return std::make_shared<NumaPlacement>(mode, std::move(topology));
+}
+
+#endif //CHOLESKY_HH_NUMA_H
@@ -0,0 +1,243 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_TILE_CACHE_H
+#define CHOLESKY_HH_TILE_CACHE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "arena.h"
+#include "../io/file_io.h"
+
+/// @brief Bounded cache of the tiles of a matrix stored in a backing file (out-of-core mode).
+///
+/// The file contains all the tiles of the grid in the tile major order (each tile takes
+/// blockSize x blockSize elements). A tile has to be acquired before being used and released
+/// afterwards: acquired tiles are pinned in memory and the other ones are evicted in LRU order
+/// when a slot is required (dirty tiles are written back). The tiles that are released as final
+/// (decomposed) are evicted first, also in LRU order: the column blocks of the last decomposed
+/// panel, still read by the trailing updates, stay in the cache while the blocks of the older panels
+/// are evicted. The I/O are done outside of the lock of the cache.
+template <typename T>
+class TileCache {
+ public:
+  TileCache(std::string const &fileName, size_t nbBlocksRows, size_t nbBlocksCols, size_t blockSize,
+            size_t capacity, bool hugePages = false)
+          : fileName_(fileName), tileSize_(blockSize * blockSize),
+            states_(nbBlocksRows * nbBlocksCols, TileStates::OnDisk),
+            tileSlot_(nbBlocksRows * nbBlocksCols, NoSlot),
+            slots_(std::min(capacity, nbBlocksRows * nbBlocksCols)) {
+    arena_ = std::make_shared<Arena>(ArenaSize<T>().add(slots_.size() * tileSize_).size(), hugePages);
+    data_ = arena_->allocate<T>(slots_.size() * tileSize_);
+
+    for (size_t slot = 0; slot < slots_.size(); ++slot) {
+      lru_.push_back(slot);
+      slots_[slot].lruIt = std::prev(lru_.end());
+    }
+
+    fd_ = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      throw std::runtime_error("cannot create " + fileName + ": " + std::strerror(errno));
+    }
+    if (ftruncate(fd_, nbBlocksRows * nbBlocksCols * tileBytes()) < 0) {
+      close(fd_);
+      throw std::runtime_error("cannot resize " + fileName + ": " + std::strerror(errno));
+    }
+  }
+
+  TileCache(TileCache const &) = delete;
+  TileCache &operator=(TileCache const &) = delete;
+
+  ~TileCache() {
+    close(fd_);
+  }
+
+  [[nodiscard]] std::string const &fileName() const { return fileName_; }
+  [[nodiscard]] size_t capacity() const { return slots_.size(); }
+
+  /// @brief Writes a tile directly in the backing file (used to initialize the file).
+  void store(size_t tile, T const *data) {
+    writeFully(fd_, data, tileBytes(), tile * tileBytes());
+  }
+
+  /// @brief Loads the tile if required and pins it. Blocks while all the slots are pinned.
+  T *acquire(size_t tile) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+      if (states_[tile] == TileStates::Resident) {
+        Slot &slot = slots_[tileSlot_[tile]];
+        if (slot.pins++ == 0) {
+          unpinned(slot).erase(slot.lruIt);
+        }
+        return slotPtr(tileSlot_[tile]);
+      } else if (states_[tile] == TileStates::Busy || (finalLru_.empty() && lru_.empty())) {
+        cv_.wait(lock);
+        continue;
+      }
+
+      // evict the least recently used slot, the final ones first
+      auto &victims = finalLru_.empty() ? lru_ : finalLru_;
+      size_t slotIdx = victims.front();
+      Slot &slot = slots_[slotIdx];
+      size_t victim = slot.tile;
+      bool writeBack = victim != NoTile && slot.dirty;
+      Slot victimSlot = slot;
+
+      victims.pop_front();
+      if (victim != NoTile) {
+        states_[victim] = writeBack ? TileStates::Busy : TileStates::OnDisk;
+        tileSlot_[victim] = NoSlot;
+      }
+      states_[tile] = TileStates::Busy;
+      tileSlot_[tile] = slotIdx;
+      slot = Slot{tile, 1, false, false, lru_.end()};
+
+      lock.unlock();
+      bool written = !writeBack;
+      try {
+        if (writeBack) {
+          writeFully(fd_, slotPtr(slotIdx), tileBytes(), victim * tileBytes());
+          written = true;
+        }
+        readFully(fd_, slotPtr(slotIdx), tileBytes(), tile * tileBytes());
+      } catch (...) {
+        lock.lock();
+        restore(slotIdx, tile, victimSlot, written);
+        throw;
+      }
+      lock.lock();
+
+      if (writeBack) {
+        states_[victim] = TileStates::OnDisk;
+      }
+      states_[tile] = TileStates::Resident;
+      cv_.notify_all();
+      return slotPtr(slotIdx);
+    }
+  }
+
+  /// @brief Unpins the tile. Dirty tiles are written back when they are evicted and final tiles
+  /// are the first candidates for eviction (least recently released first).
+  void release(size_t tile, bool dirty, bool final) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t slotIdx = tileSlot_[tile];
+    Slot &slot = slots_[slotIdx];
+
+    slot.dirty |= dirty;
+    slot.final |= final;
+    if (--slot.pins == 0) {
+      slot.lruIt = unpinned(slot).insert(unpinned(slot).end(), slotIdx);
+      cv_.notify_all();
+    }
+  }
+
+  /// @brief Asks the kernel to start reading a tile that will be needed soon.
+  void prefetch(size_t tile) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (states_[tile] == TileStates::OnDisk) {
+      lock.unlock();
+      posix_fadvise(fd_, tile * tileBytes(), tileBytes(), POSIX_FADV_WILLNEED);
+    }
+  }
+
+  /// @brief Writes all the dirty tiles in the backing file.
+  void flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t slotIdx = 0; slotIdx < slots_.size(); ++slotIdx) {
+      if (slots_[slotIdx].tile != NoTile && slots_[slotIdx].dirty) {
+        writeFully(fd_, slotPtr(slotIdx), tileBytes(), slots_[slotIdx].tile * tileBytes());
+        slots_[slotIdx].dirty = false;
+      }
+    }
+    fdatasync(fd_);
+  }
+
+ private:
+  enum class TileStates : uint8_t {
+    OnDisk,
+    Resident,
+    Busy, // being read or written back
+  };
+
+  static constexpr size_t NoTile = (size_t) -1;
+  static constexpr size_t NoSlot = (size_t) -1;
+
+  struct Slot {
+    size_t tile = NoTile;
+    size_t pins = 0;
+    bool dirty = false;
+    bool final = false;
+    std::list<size_t>::iterator lruIt = {};
+  };
+
+  std::string fileName_;
+  size_t tileSize_ = 0;
+  std::vector<TileStates> states_ = {};
+  std::vector<size_t> tileSlot_ = {};
+  std::vector<Slot> slots_ = {};
+  std::list<size_t> lru_ = {};      // unpinned slots, the front is evicted first
+  std::list<size_t> finalLru_ = {}; // unpinned final slots, evicted before the ones of lru_
+  std::shared_ptr<Arena> arena_ = nullptr;
+  T *data_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int fd_ = -1;
+
+  [[nodiscard]] size_t tileBytes() const { return tileSize_ * sizeof(T); }
+  [[nodiscard]] T *slotPtr(size_t slot) const { return data_ + slot * tileSize_; }
+
+  /// @brief Called with the lock when the I/O of acquire fail: the tile goes back on disk and the
+  /// slot gets back the victim if it was not written back yet (it is still in the slot), otherwise
+  /// the slot is empty. The threads waiting for the tiles are woken up.
+  void restore(size_t slotIdx, size_t tile, Slot victimSlot, bool written) {
+    Slot &slot = slots_[slotIdx];
+    size_t victim = victimSlot.tile;
+
+    states_[tile] = TileStates::OnDisk;
+    tileSlot_[tile] = NoSlot;
+    if (victim != NoTile && !written) {
+      states_[victim] = TileStates::Resident;
+      tileSlot_[victim] = slotIdx;
+      slot = victimSlot;
+      slot.pins = 0;
+      slot.lruIt = unpinned(slot).insert(unpinned(slot).end(), slotIdx);
+    } else {
+      if (victim != NoTile) {
+        states_[victim] = TileStates::OnDisk;
+      }
+      slot = Slot{};
+      slot.lruIt = lru_.insert(lru_.begin(), slotIdx); // empty slot, used first
+    }
+    cv_.notify_all();
+  }
+
+  /// @brief List of the slot when it is not pinned.
+  std::list<size_t> &unpinned(Slot const &slot) { return slot.final ? finalLru_ : lru_; }
+};
+
+#endif //CHOLESKY_HH_TILE_CACHE_H
@@ -0,0 +1,126 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_REFINEMENT_H
+#define CHOLESKY_HH_REFINEMENT_H
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "config.h"
+#include "data/matrix_data.h"
+#include "graph/cholesky_refinement_graph.h"
+#include "io/parallel_loader.h"
+#include "kernels/blas.h"
+
+/// @brief Solves L.L^T.x = rhs in place with the refinement graph, which already received the
+/// factor L. Returns when all the blocks of rhs are solved.
+template <typename T>
+void solveFactorized(CholeskyRefinementGraph<T> &refinementGraph,
+                     std::shared_ptr<MatrixData<T, MatrixTypes::Vector>> rhs) {
+  refinementGraph.pushData(rhs);
+  for (size_t iBlock = 0; iBlock < rhs->nbBlocksRows(); ++iBlock) {
+    refinementGraph.getBlockingResult();
+  }
+}
+
+/// @brief Copies the lower part of a matrix in a matrix of another scalar type (the tile rows are
+/// converted in parallel).
+template <typename To, typename From>
+void convertLower(MatrixData<From, MatrixTypes::Matrix> const &from, MatrixData<To, MatrixTypes::Matrix> &to) {
+  parallelFor(to.nbBlocksRows(), [&](size_t iBlock) {
+    size_t end = std::min(to.height(), (iBlock + 1) * to.blockSize());
+
+    for (size_t i = iBlock * to.blockSize(); i < end; ++i) {
+      for (size_t j = 0; j <= i; ++j) {
+        to.get()[to.index(i, j)] = (To) from.at(i, j);
+      }
+    }
+  });
+}
+
+/// @brief Iterative refinement of the solution x of A.x = b using the factorization of A computed
+/// with a lower precision (Low): x = x + (L.L^T)^-1 (b - A.x). The residual is computed with the
+/// precision of A (the lower part of the row major matrix A is used). The refinement stops when
+/// the residual reaches the precision of T, when it doesn't decrease anymore (the last correction
+/// is then discarded) or after config.refinementSteps steps.
+template <typename T, typename Low>
+size_t refineSolution(Config const &config,
+                      MatrixData<T, MatrixTypes::Matrix> &A,
+                      MatrixData<T, MatrixTypes::Vector> &b,
+                      std::shared_ptr<MatrixData<Low, MatrixTypes::Matrix>> factor,
+                      std::shared_ptr<MatrixData<Low, MatrixTypes::Vector>> correction,
+                      MatrixData<T, MatrixTypes::Vector> &x) {
+  auto n = (int32_t) A.height();
+  std::vector<T> residual(n);
+  std::vector<T> previousX(n); // solution before the last correction
+  T bNorm = blas::nrm2(n, b.get());
+  T tolerance = std::numeric_limits<T>::epsilon() * std::sqrt((T) n);
+  T previousNorm = std::numeric_limits<T>::max();
+  T residualNorm = 0;
+  size_t step = 0;
+  auto begin = std::chrono::system_clock::now();
+  // the graph is built once, the factor is split in blocks only once for all the steps
+  CholeskyRefinementGraph<Low> refinementGraph(config.threadsConfig.nbThreadsSolveDiagonal,
+                                               config.threadsConfig.nbThreadsUpdateVector);
+
+  refinementGraph.executeGraph(true);
+  refinementGraph.pushData(factor);
+
+  for (;; ++step) {
+    std::copy(b.get(), b.get() + n, residual.begin());
+    blas::symv(n, (T) -1, A.get(), A.width(), x.get(), (T) 1, residual.data());
+    residualNorm = blas::nrm2(n, residual.data()) / bNorm;
+
+    if (step > 0 && residualNorm >= previousNorm) {
+      // the last correction didn't help, go back to the previous solution
+      std::copy(previousX.begin(), previousX.end(), x.get());
+      residualNorm = previousNorm;
+      --step;
+      break;
+    }
+    if (residualNorm <= tolerance || step == config.refinementSteps) {
+      break;
+    }
+    previousNorm = residualNorm;
+
+    for (int32_t i = 0; i < n; ++i) {
+      correction->get()[i] = (Low) residual[i];
+    }
+    solveFactorized(refinementGraph, correction);
+    std::copy(x.get(), x.get() + n, previousX.begin());
+    for (int32_t i = 0; i < n; ++i) {
+      x.get()[i] += (T) correction->get()[i];
+    }
+  }
+
+  refinementGraph.finishSolving();
+  refinementGraph.finishPushingData();
+  refinementGraph.waitForTermination();
+
+  auto end = std::chrono::system_clock::now();
+  std::cout << "refinement: " << step << " steps, residual " << residualNorm << " "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms"
+            << std::endl;
+  return step;
+}
+
+#endif //CHOLESKY_HH_REFINEMENT_H
@@ -20,6 +20,7 @@
 #define DECOMPOSE_STATE_H
 
 #include "../../data/matrix_block_data.h"
+#include "../../data/tile_table.h"
 #include "../../task/decomposition/compute_column_block_task.h"
 #include "hedgehog/hedgehog/hedgehog.h"
 #include <vector>
@@ -38,25 +39,29 @@
   MatrixBlockData<T, Updated>,     \
   MatrixBlockData<T, Decomposed>
 
+/// @brief State of the right looking decomposition. The blocks are stored in the tile table shared
+/// with the update state and the solver, a block is sent to the update state only when it waits for
+/// it (streamed matrix).
 template <typename T>
 class DecomposeState : public hh::AbstractState<DStateInNb, DStateIn, DStateOut > {
  public:
-  explicit DecomposeState() : hh::AbstractState<DStateInNb, DStateIn, DStateOut >() {}
+  explicit DecomposeState(std::shared_ptr<TileTable<T>> tiles)
+          : hh::AbstractState<DStateInNb, DStateIn, DStateOut >(), tiles_(std::move(tiles)) {}
 
   /* Blocks *******************************************************************/
 
   /// @brief Receives the blocks from the SplitMatrix task.
   void execute(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> block) override {
-    // init array and blockttl on first call
-    if (blocks_.size() == 0) {
+    // init table and blockttl on first call
+    if (nbBlocksCols_ == 0) {
       init(block->nbBlocksRows(), block->nbBlocksCols());
       blocksTtl_ = (nbBlocksCols_ * (nbBlocksCols_ + 1)) / 2;
     }
-
-    blocks_[block->y() * nbBlocksRows_ + block->x()] = block;
     --blocksTtl_;
 
-    this->addResult(block); // send the block to the update state
+    if (tiles_->insert(block)) {
+      this->addResult(block); // the update state waits for the block
+    }
     tryProcessBlock(block); // start early computation if possible
   }
 
@@ -64,30 +69,36 @@ class DecomposeState : public hh::AbstractState<DStateInNb, DStateIn, DStateOut
 
   /// @brief Receives blocks from the ComputeDiagonalBlock task
   void execute(std::shared_ptr<MatrixBlockData<T, Diagonal>> diag) override {
-    blocks_[diag->idx()]->incRank();
+    tiles_->get(diag->idx())->incRank();
+    prefetchColumn(diag->x() + 1);
 
     for (size_t i = diag->y() + 1; i < nbBlocksCols_; ++i) {
-      auto block = blocks_[i * nbBlocksCols_ + diag->x()];
+      auto block = tiles_->get(i * nbBlocksCols_ + diag->x());
       if (block && block->isReady()) {
-        this->addResult(std::make_shared<CCBTaskInputType<T>>(diag, block));
+        // the blocks are acquired in new handles owned by the message (the handles of the table are
+        // read by the other states)
+        auto diagCopy = makeMessage<MatrixBlockData<T, Diagonal>>(diag);
+        auto blockCopy = makeMessage<MatrixBlockData<T, MatrixBlock>>(block);
+        diagCopy->acquire();
+        blockCopy->acquire();
+        this->addResult(makeMessage<CCBTaskInputType<T>>(diagCopy, blockCopy));
       }
     }
     // the block is done so we can output the result
-    this->addResult(std::make_shared<MatrixBlockData<T, Decomposed>>(std::move(diag)));
+    this->addResult(makeMessage<MatrixBlockData<T, Decomposed>>(std::move(diag)));
   }
 
   /* Column *******************************************************************/
 
   /// @brief Receives blocks from the ComputeColumn task
   void execute(std::shared_ptr<MatrixBlockData<T, Column>> col) override {
-    blocks_[col->idx()]->incRank();
-    col->incRank();
+    col->incRank(); // the rank is shared with the block of the table
 
     // send block to the update state
     this->addResult(col);
 
     // the block is done so we can output the result
-    this->addResult(std::make_shared<MatrixBlockData<T, Decomposed>>(std::move(col)));
+    this->addResult(makeMessage<MatrixBlockData<T, Decomposed>>(std::move(col)));
   }
 
   /* Updated ******************************************************************/
@@ -95,20 +106,25 @@ class DecomposeState : public hh::AbstractState<DStateInNb, DStateIn, DStateOut
   /// @brief Receives the updated blocks from the UpdateBlocks task. When all the blocks are
   /// updated, we start a new column.
   void execute(std::shared_ptr<MatrixBlockData<T, Updated>> block) override {
-    blocks_[block->idx()]->incRank();
+    auto updated = tiles_->get(block->idx());
 
-    tryProcessBlock(blocks_[block->idx()]);
+    updated->incRank();
+    tryProcessBlock(updated);
     this->addResult(block); // we may have to notify the update state
   }
 
   /* idDone ******************************************************************/
 
   [[nodiscard]] bool isDone() const {
-    return !blocks_.empty() && blocks_.back() && blocks_.back()->isProcessed();
+    if (tiles_->empty()) {
+      return false;
+    }
+    auto last = tiles_->get(tiles_->size() - 1);
+    return last && last->isProcessed();
   }
 
  private:
-  std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>> blocks_ = {};
+  std::shared_ptr<TileTable<T>> tiles_ = nullptr;
   size_t nbBlocksRows_ = 0;
   size_t nbBlocksCols_ = 0;
   size_t blocksTtl_ = 0;
@@ -118,21 +134,34 @@ class DecomposeState : public hh::AbstractState<DStateInNb, DStateIn, DStateOut
   void init(size_t nbBlocksRows, size_t nbBlocksCols) {
     nbBlocksRows_ = nbBlocksRows;
     nbBlocksCols_ = nbBlocksCols;
-    blocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>>(
-            nbBlocksRows_ * nbBlocksCols_, nullptr);
+    tiles_->init(nbBlocksRows, nbBlocksCols);
   }
 
   void tryProcessBlock(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> &block) {
     if (block->isReady()) {
+      // the blocks are acquired in new handles owned by the messages (see execute(Diagonal))
       if (block->isDiag()) {
-        this->addResult(std::make_shared<MatrixBlockData<T, Diagonal>>(block));
-      } else if (blocks_[block->diagIdx()]->isProcessed()) {
-        this->addResult(std::make_shared<CCBTaskInputType<T>>(
-                std::make_shared<MatrixBlockData<T, Diagonal>>(blocks_[block->diagIdx()]),
-                block));
+        auto diagCopy = makeMessage<MatrixBlockData<T, Diagonal>>(block);
+        diagCopy->acquire();
+        this->addResult(diagCopy);
+      } else if (auto diag = tiles_->get(block->diagIdx()); diag && diag->isProcessed()) {
+        auto diagCopy = makeMessage<MatrixBlockData<T, Diagonal>>(diag);
+        auto blockCopy = makeMessage<MatrixBlockData<T, MatrixBlock>>(block);
+        diagCopy->acquire();
+        blockCopy->acquire();
+        this->addResult(makeMessage<CCBTaskInputType<T>>(diagCopy, blockCopy));
       } // else the block will be treated when the diag element is received
     }
   }
+
+  /// @brief Out-of-core mode: starts loading the blocks of the next column.
+  void prefetchColumn(size_t col) {
+    for (size_t i = col; i < nbBlocksRows_; ++i) {
+      if (auto block = tiles_->get(i * nbBlocksCols_ + col)) {
+        block->prefetch();
+      }
+    }
+  }
 };
 
 #endif
@@ -0,0 +1,166 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_LEFT_LOOKING_STATE_H
+#define CHOLESKY_HH_LEFT_LOOKING_STATE_H
+
+#include <vector>
+#include "hedgehog/hedgehog/hedgehog.h"
+#include "../../data/matrix_block_data.h"
+#include "../../data/panel_update_data.h"
+#include "../../data/tile_table.h"
+#include "../../task/decomposition/compute_column_block_task.h"
+
+#define LLStateInNb 4
+#define LLStateIn                  \
+  MatrixBlockData<T, MatrixBlock>, \
+  MatrixBlockData<T, Diagonal>,    \
+  MatrixBlockData<T, Column>,      \
+  MatrixBlockData<T, Updated>
+#define LLStateOut                 \
+  MatrixBlockData<T, Diagonal>,    \
+  CCBTaskInputType<T>,             \
+  PanelUpdateData<T>,              \
+  MatrixBlockData<T, Decomposed>
+
+/// @brief State of the left looking decomposition. A block (i, j) is updated once, when the blocks
+/// (i, 0..j-1) and (j, 0..j-1) are decomposed. As the blocks of a row are decomposed from left to
+/// right, the state only counts the decomposed blocks of each row. The blocks are stored in the tile
+/// table shared with the solver.
+template <typename T>
+class LeftLookingState : public hh::AbstractState<LLStateInNb, LLStateIn, LLStateOut > {
+ public:
+  explicit LeftLookingState(std::shared_ptr<TileTable<T>> tiles)
+          : hh::AbstractState<LLStateInNb, LLStateIn, LLStateOut >(), tiles_(std::move(tiles)) {}
+
+  /* Blocks *******************************************************************/
+
+  /// @brief Receives the blocks from the SplitMatrix (or StreamMatrix) task.
+  void execute(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> block) override {
+    if (nbBlocks_ == 0) {
+      init(block->nbBlocksCols());
+    }
+    tiles_->insert(block);
+    tryUpdate(block->y(), block->x());
+  }
+
+  /* Updated ******************************************************************/
+
+  /// @brief Receives the blocks updated by the UpdatePanelBlock task.
+  void execute(std::shared_ptr<MatrixBlockData<T, Updated>> block) override {
+    updated(block->y(), block->x());
+  }
+
+  /* Diagonal *****************************************************************/
+
+  /// @brief Receives the blocks from the ComputeDiagonalBlock task, the blocks of the column that
+  /// are already updated can be computed.
+  void execute(std::shared_ptr<MatrixBlockData<T, Diagonal>> diag) override {
+    size_t col = diag->x();
+
+    decomposed(col, col);
+    for (size_t i = col + 1; i < nbBlocks_; ++i) {
+      if (updated_[i * nbBlocks_ + col]) {
+        computeColumn(i, col);
+      }
+    }
+    this->addResult(makeMessage<MatrixBlockData<T, Decomposed>>(std::move(diag)));
+  }
+
+  /* Column *******************************************************************/
+
+  /// @brief Receives blocks from the ComputeColumn task
+  void execute(std::shared_ptr<MatrixBlockData<T, Column>> col) override {
+    decomposed(col->y(), col->x());
+    this->addResult(makeMessage<MatrixBlockData<T, Decomposed>>(std::move(col)));
+  }
+
+  /* isDone *******************************************************************/
+
+  [[nodiscard]] bool isDone() const {
+    return nbBlocks_ && nbDecomposed_ == nbBlocks_ * (nbBlocks_ + 1) / 2;
+  }
+
+ private:
+  std::shared_ptr<TileTable<T>> tiles_ = nullptr;
+  std::vector<bool> sent_ = {};                // the block is sent to the update task
+  std::vector<bool> updated_ = {};             // the block has received all its updates
+  std::vector<size_t> nbDecomposedInRow_ = {}; // number of decomposed blocks of each row
+  size_t nbBlocks_ = 0;
+  size_t nbDecomposed_ = 0;
+
+  /* helper functions *********************************************************/
+
+  void init(size_t nbBlocks) {
+    nbBlocks_ = nbBlocks;
+    tiles_->init(nbBlocks, nbBlocks);
+    sent_ = std::vector<bool>(nbBlocks * nbBlocks, false);
+    updated_ = std::vector<bool>(nbBlocks * nbBlocks, false);
+    nbDecomposedInRow_ = std::vector<size_t>(nbBlocks, 0);
+  }
+
+  /// @brief Sends the block (i, j) to the update task when the blocks it depends on are decomposed.
+  void tryUpdate(size_t i, size_t j) {
+    size_t idx = i * nbBlocks_ + j;
+
+    if (sent_[idx] || !tiles_->get(idx) || nbDecomposedInRow_[i] < j || nbDecomposedInRow_[j] < j) {
+      return;
+    }
+    sent_[idx] = true;
+    if (j == 0) {
+      updated(i, j); // nothing to do on the first column
+    } else {
+      this->addResult(makeMessage<PanelUpdateData<T>>(tiles_->get(idx), tiles_));
+    }
+  }
+
+  void updated(size_t i, size_t j) {
+    size_t idx = i * nbBlocks_ + j;
+
+    if (i == j) {
+      this->addResult(makeMessage<MatrixBlockData<T, Diagonal>>(tiles_->get(idx)));
+    } else {
+      updated_[idx] = true;
+      if (nbDecomposedInRow_[j] > j) {
+        computeColumn(i, j);
+      }
+    }
+  }
+
+  void computeColumn(size_t i, size_t j) {
+    this->addResult(makeMessage<CCBTaskInputType<T>>(
+            makeMessage<MatrixBlockData<T, Diagonal>>(tiles_->get(j * nbBlocks_ + j)),
+            tiles_->get(i * nbBlocks_ + j)));
+  }
+
+  /// @brief The block (i, j) is decomposed: the next block of the row can be updated, and when the
+  /// row is complete up to the diagonal, the blocks of the column i can be updated.
+  void decomposed(size_t i, size_t j) {
+    nbDecomposedInRow_[i] = j + 1;
+    ++nbDecomposed_;
+    if (j + 1 < i) {
+      tryUpdate(i, j + 1);
+    } else if (j + 1 == i) {
+      for (size_t row = i; row < nbBlocks_; ++row) {
+        tryUpdate(row, i);
+      }
+    }
+  }
+};
+
+#endif //CHOLESKY_HH_LEFT_LOOKING_STATE_H
@@ -20,9 +20,11 @@
 #define CHOLESKY_HH_UPDATE_SUBMATRIX_STATE_H
 
 #include <vector>
-#include <list>
+#include <map>
+#include <queue>
 #include "hedgehog/hedgehog/hedgehog.h"
 #include "../../data/matrix_block_data.h"
+#include "../../data/tile_table.h"
 #include "../../task/decomposition/update_submatrix_block_task.h"
 
 #define USMStateInNb 3
@@ -32,30 +34,41 @@
   MatrixBlockData<T, Updated>
 #define USMStateOut UpdateSubmatrixBlockInputType<T>
 
+/// @brief Sends the updates of the blocks (triples col1, col2, updated) when their dependencies are
+/// satisfied. The updates of a block are applied in the order of the columns: the update by the
+/// column k can only be done when the rank of the block is k. So the pending updates are indexed by
+/// block and by column, and only the update matching the rank of the block is checked. When a
+/// column block of this update is not decomposed yet, the updated block waits on the column block.
+/// Each message only checks the updates that it can unblock. The blocks are read from the tile table
+/// shared with the decompose state, a missing updated block (streamed matrix) is watched in the
+/// table, and the decompose state sends it when it is inserted.
+///
+/// The queue of the update task is FIFO, so the updates that unblock the next column could wait
+/// behind all the updates of the trailing matrix. When maxInFlight is set, only maxInFlight updates
+/// are sent to the task, the other ready updates wait in a priority queue of the state: the updates
+/// of the leftmost columns first (critical path), and the diagonal block first in a column. Each
+/// Updated message releases the most urgent ready update.
+///
+/// Lookahead: the updates of the next lookahead columns (from the first column whose diagonal block
+/// is not decomposed, found with the ranks of the blocks) don't wait for the window, so the
+/// diagonal and column tasks of these panels are started by the decompose state (tryProcessBlock)
+/// while the update task works on the rest of the trailing matrix.
 template <typename T>
 class UpdateSubMatrixState : public hh::AbstractState<USMStateInNb, USMStateIn, USMStateOut > {
  public:
-  UpdateSubMatrixState() :
-          hh::AbstractState<USMStateInNb, USMStateIn, USMStateOut >() {}
+  explicit UpdateSubMatrixState(std::shared_ptr<TileTable<T>> tiles, size_t maxInFlight = 0,
+                                size_t lookahead = 0) :
+          hh::AbstractState<USMStateInNb, USMStateIn, USMStateOut >(), tiles_(std::move(tiles)),
+          maxInFlight_(maxInFlight), lookahead_(lookahead) {}
 
   /* Block ********************************************************************/
 
-  /// @brief Receives the blocks from the SplitMatrix task and store them.
+  /// @brief Receives the watched blocks from the decompose state. When the matrix is streamed, the
+  /// blocks can arrive after the columns used to update them.
   void execute(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> block) override {
-    // special case for the first block received (may change as we can also give the information threw constructor)
-    if (blocks_.size() == 0) {
-      blocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>>(
-              block->nbBlocksCols() * block->nbBlocksRows(), nullptr);
-      blocksTtl_ = (block->nbBlocksCols() * (block->nbBlocksCols() + 1)) / 2;
-      nbBlocksCols_ = block->nbBlocksCols();
-    }
-
-    blocks_[block->y() * block->nbBlocksCols() + block->x()] = block;
-    --blocksTtl_;
-
-    if (blocksTtl_ == 0) {
-      processPending();
-    }
+    init(block->nbBlocksRows(), block->nbBlocksCols());
+    tryUpdate(block->idx());
+    sendReady();
   }
 
   /* Column *******************************************************************/
@@ -63,27 +76,40 @@ class UpdateSubMatrixState : public hh::AbstractState<USMStateInNb, USMStateIn,
   /// @brief Receives result blocks from the ComputeColumn task. This blocks are used to update the
   /// rest of the matrix in the UpdateBlocks task.
   void execute(std::shared_ptr<MatrixBlockData<T, Column>> col) override {
+    init(col->nbBlocksRows(), col->nbBlocksCols());
     for (size_t i = col->y(); i < nbBlocksCols_; ++i) {
       size_t col1Idx = i * nbBlocksCols_ + col->x();
       size_t col2Idx = col->idx();
       size_t updatedIdx = i * nbBlocksCols_ + col->y();
 
-      pending_.emplace_back(TripleIndex(col1Idx, col2Idx, updatedIdx));
+      pending_[updatedIdx].emplace(col->x(), TripleIndex(col1Idx, col2Idx, updatedIdx, col->packed()));
+      if (auto updated = tiles_->get(updatedIdx)) {
+        updated->prefetch(); // out-of-core mode
+      }
+      tryUpdate(updatedIdx);
     }
-    processPending();
+    wakeUp(col->idx());
+    sendReady();
   }
 
   /* Updated ******************************************************************/
 
-  /// @brief Receives updated blocks from decompose state
-  void execute(std::shared_ptr<MatrixBlockData<T, Updated>>) override {
-    processPending();
+  /// @brief Receives updated blocks from decompose state (the rank of the block is incremented),
+  /// the next update of the block can be sent.
+  void execute(std::shared_ptr<MatrixBlockData<T, Updated>> block) override {
+    --nbInFlight_;
+    tryUpdate(block->idx());
+    sendReady();
   }
 
   /* isDone *******************************************************************/
 
   [[nodiscard]] bool isDone() const {
-    return blocks_.size() && blocks_.back() && blocks_.back()->isProcessed();
+    if (tiles_->empty()) {
+      return false; // with one block, the update state doesn't receive any message
+    }
+    auto last = tiles_->get(tiles_->size() - 1);
+    return last && last->isProcessed();
   }
 
  private:
@@ -91,39 +117,118 @@ class UpdateSubMatrixState : public hh::AbstractState<USMStateInNb, USMStateIn,
   /* Types ********************************************************************/
 
   struct TripleIndex {
-    TripleIndex(size_t col1Idx, size_t col2Idx, size_t updateIdx) :
-            col1Idx(col1Idx), col2Idx(col2Idx), updateIdx(updateIdx) {}
+    TripleIndex(size_t col1Idx, size_t col2Idx, size_t updateIdx, std::shared_ptr<T[]> packed2) :
+            col1Idx(col1Idx), col2Idx(col2Idx), updateIdx(updateIdx), packed2(std::move(packed2)) {}
     size_t col1Idx;
     size_t col2Idx;
     size_t updateIdx;
+    std::shared_ptr<T[]> packed2; // packed copy of the column block (freed after its last update)
+  };
+
+  /// @brief Update ready to be sent, ordered by priority (the smallest column, then the smallest row
+  /// of the updated block is the most urgent).
+  struct ReadyUpdate {
+    std::shared_ptr<TripleBlockData<T>> triple;
+
+    bool operator<(ReadyUpdate const &other) const {
+      auto const &block = triple->third;
+      auto const &otherBlock = other.triple->third;
+      return std::make_pair(block->x(), block->y()) > std::make_pair(otherBlock->x(), otherBlock->y());
+    }
   };
 
   /* Variables ****************************************************************/
 
-  std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>> blocks_ = {};
-  std::list<TripleIndex> pending_ = {};
-  size_t blocksTtl_ = 0;
+  std::shared_ptr<TileTable<T>> tiles_ = nullptr;
+  std::vector<std::map<size_t, TripleIndex>> pending_ = {}; // pending updates of each block by column
+  std::vector<std::vector<size_t>> waiting_ = {}; // updated blocks waiting for each column block
+  std::priority_queue<ReadyUpdate> ready_ = {};
+  size_t maxInFlight_ = 0; // maximum number of updates in the queue of the task (0: no limit)
+  size_t nbInFlight_ = 0;
+  size_t lookahead_ = 0;   // number of columns whose updates are sent without waiting
+  size_t firstColumn_ = 0; // first column whose diagonal block is not decomposed
   size_t nbBlocksCols_ = 0;
 
   /* Process function *********************************************************/
 
-  void processPending() {
-    auto it = pending_.begin();
-
-    while (it != pending_.end()) {
-      auto col1 = blocks_[it->col1Idx];
-      auto col2 = blocks_[it->col2Idx];
-      auto updated = blocks_[it->updateIdx];
-      bool col1Processed = col1 && col1->isProcessed();
-      bool col2Processed = col2 && col2->isProcessed();
-      bool updatedReady = col1 && updated && updated->isUpdateable(col1->rank());
-
-      if (col1Processed && col2Processed && updatedReady) {
-        this->addResult(std::make_shared<TripleBlockData<T>>(col1, col2, updated));
-        it = pending_.erase(it);
-      } else {
-        it++;
+  void init(size_t nbBlocksRows, size_t nbBlocksCols) {
+    if (nbBlocksCols_ == 0) {
+      tiles_->init(nbBlocksRows, nbBlocksCols);
+      pending_ = std::vector<std::map<size_t, TripleIndex>>(nbBlocksCols * nbBlocksRows);
+      waiting_ = std::vector<std::vector<size_t>>(nbBlocksCols * nbBlocksRows);
+      nbBlocksCols_ = nbBlocksCols;
+    }
+  }
+
+  /// @brief Sends the next update of the block updateIdx if it is ready.
+  void tryUpdate(size_t updateIdx) {
+    auto updated = tiles_->get(updateIdx);
+
+    if (!updated) {
+      if (tiles_->watch(updateIdx)) {
+        return; // the update is checked again when the block is received
       }
+      updated = tiles_->get(updateIdx); // inserted in the meantime
+    }
+    auto it = pending_[updateIdx].find(updated->rank());
+    if (it == pending_[updateIdx].end()) {
+      return; // the column of the next update is not decomposed yet
+    }
+    for (size_t colIdx : {it->second.col1Idx, it->second.col2Idx}) {
+      auto col = tiles_->get(colIdx);
+      if (!col || !col->isProcessed()) {
+        waiting_[colIdx].push_back(updateIdx);
+        return;
+      }
+    }
+    auto col1 = tiles_->get(it->second.col1Idx);
+    auto col2 = tiles_->get(it->second.col2Idx);
+
+    if (updated->isUpdateable(col1->rank())) {
+      // the triple owns new handles, they are acquired by sendReady (the handles of the table are
+      // read by the other states)
+      ready_.push({makeMessage<TripleBlockData<T>>(
+              makeMessage<MatrixBlockData<T, MatrixBlock>>(col1),
+              makeMessage<MatrixBlockData<T, MatrixBlock>>(col2),
+              makeMessage<MatrixBlockData<T, MatrixBlock>>(updated),
+              std::move(it->second.packed2))});
+      pending_[updateIdx].erase(it);
+    }
+  }
+
+  /// @brief Sends the most urgent ready updates while the task has less than maxInFlight updates,
+  /// the updates of the lookahead columns are always sent.
+  void sendReady() {
+    while (firstColumn_ < nbBlocksCols_) {
+      auto diag = tiles_->get(firstColumn_ * nbBlocksCols_ + firstColumn_);
+      if (!diag || !diag->isProcessed()) {
+        break;
+      }
+      ++firstColumn_;
+    }
+    while (!ready_.empty()) {
+      auto triple = ready_.top().triple;
+      bool isLookahead = triple->third->x() < firstColumn_ + lookahead_;
+
+      if (!isLookahead && maxInFlight_ != 0 && nbInFlight_ >= maxInFlight_) {
+        break; // the updates are sorted by column, so the others are not in the lookahead either
+      }
+      ready_.pop();
+      triple->first->acquire();
+      triple->second->acquire();
+      triple->third->acquire();
+      this->addResult(triple);
+      ++nbInFlight_;
+    }
+  }
+
+  /// @brief Checks the updates that were waiting for the block idx.
+  void wakeUp(size_t idx) {
+    std::vector<size_t> waiting;
+
+    std::swap(waiting, waiting_[idx]);
+    for (size_t updateIdx : waiting) {
+      tryUpdate(updateIdx);
     }
   }
 };
@@ -20,11 +20,13 @@
 #define SOLVER_STATE_H
 
 #include "../../data/matrix_block_data.h"
+#include "../../data/tile_table.h"
 #include "../../data/solver/phases.h"
 #include "../../task/solver/update_vector_task.h"
 #include "../../task/solver/solve_diagonal_task.h"
+#include <algorithm>
 #include <vector>
-#include <list>
+#include <map>
 
 #define SStateInNb 5
 #define SStateIn                         \
@@ -39,25 +41,40 @@
   MatrixBlockData<T, VectorBlockPhase1>,  \
   MatrixBlockData<T, Result>
 
+/// @brief Sends the diagonal solves and the vector updates of a solver phase when their blocks are
+/// ready. The updates of a vector block are applied in a fixed order (increasing solved blocks in
+/// the first phase, decreasing in the second), so the pending updates are indexed by updated vector
+/// block and by solved block, and only the next update of a vector block is checked. The column
+/// block of this update only depends on the vector blocks, so each message checks only the vector
+/// block that it can unblock. The matrix blocks are read from the tile table shared with the
+/// decomposition, the state only marks the decomposed blocks (the table is filled with the Decomposed
+/// blocks when the solver runs without the decomposition). Several vectors can be solved one after
+/// the other with the same matrix (iterative refinement): the vector blocks are cleared when a
+/// vector is solved, and the state terminates after nbSolves vectors.
 template <typename T, Phases Phase>
 class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
  public:
-  SolverState() : hh::AbstractState<SStateInNb, SStateIn, SStateOut >() {}
+  explicit SolverState(std::shared_ptr<TileTable<T>> tiles, size_t nbSolves = 1)
+          : hh::AbstractState<SStateInNb, SStateIn, SStateOut >(), tiles_(std::move(tiles)),
+            nbSolves_(nbSolves) {}
 
   /* Decomposed ***************************************************************/
 
   /// @brief Receives the blocks from the cholesky decomposition graph
   void execute(std::shared_ptr<MatrixBlockData<T, Decomposed>> block) override {
-    if (blocks_.size() == 0) {
-      nbBlocksCols_ = block->nbBlocksCols();
-      nbBlocksRows_ = block->nbBlocksRows();
-      blocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>>(
-              block->nbBlocksCols() * block->nbBlocksRows(), nullptr);
+    init(block->nbBlocksRows());
+    if (!tiles_->get(block->idx())) {
+      tiles_->insert(std::make_shared<MatrixBlockData<T, MatrixBlock>>(block));
     }
+    decomposed_[block->idx()] = true;
 
-    blocks_[block->idx()] = std::make_shared<MatrixBlockData<T, MatrixBlock>>(block);
-    sendSolveDiagPending();
-    sendUpdatePending();
+    if (block->isDiag()) {
+      trySolveDiagonal(block->y());
+    } else if constexpr (Phase == Phases::First) {
+      tryUpdateVector(block->y()); // the block (i, j) updates the vector block i with j
+    } else {
+      tryUpdateVector(block->x()); // the block (i, j) updates the vector block j with i (transposed)
+    }
   }
 
   /* VectorBlock **************************************************************/
@@ -65,21 +82,14 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
   /// @brief Receives the vector blocks from the split matrix task
   void execute(std::shared_ptr<MatrixBlockData<T, VectorBlock>> vecBlock) override {
     if constexpr (Phase == Phases::First) {
-      if (vectorBlocks_.size() == 0) {
-        vectorBlocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, Vector>>>(
-                vecBlock->nbBlocksRows(), nullptr);
-      }
-
+      init(vecBlock->nbBlocksRows());
       vectorBlocks_[vecBlock->idx()] = std::make_shared<MatrixBlockData<T, Vector>>(vecBlock);
 
       if (vecBlock->rank() == vecBlock->y()) {
-        solveDiagPending_.emplace_back(SolveDiagonalIdx(
-                vecBlock->y() * nbBlocksCols_ + vecBlock->y(),
-                vecBlock->idx()
-        ));
+        solveReady_[vecBlock->idx()] = true;
+        trySolveDiagonal(vecBlock->idx());
       }
-      sendSolveDiagPending();
-      sendUpdatePending();
+      tryUpdateVector(vecBlock->idx());
     }
   }
 
@@ -88,22 +98,17 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
   /// @brief Receives the vector blocks from the phase 1
   void execute(std::shared_ptr<MatrixBlockData<T, VectorBlockPhase1>> vecBlock) override {
     if constexpr (Phase == Phases::Second) {
-      if (vectorBlocks_.size() == 0) {
-        vectorBlocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, Vector>>>(
-                vecBlock->nbBlocksRows(), nullptr);
-      }
-
-      vecBlock->rank(nbBlocksRows_ - vecBlock->y());
-      vectorBlocks_[vecBlock->idx()] = std::make_shared<MatrixBlockData<T, Vector>>(vecBlock);
-
-      if (vecBlock->rank() == 1) {
-        solveDiagPending_.emplace_back(SolveDiagonalIdx(
-                vecBlock->y() * nbBlocksCols_ + vecBlock->y(),
-                vecBlock->idx()
-        ));
+      init(vecBlock->nbBlocksRows());
+      auto vec = std::make_shared<MatrixBlockData<T, Vector>>(vecBlock);
+      vec->detach(); // the first phase still reads its rank
+      vec->rank(vecBlock->nbBlocksRows() - vecBlock->y());
+      vectorBlocks_[vecBlock->idx()] = vec;
+
+      if (vec->rank() == 1) {
+        solveReady_[vecBlock->idx()] = true;
+        trySolveDiagonal(vecBlock->idx());
       }
-      sendSolveDiagPending();
-      sendUpdatePending();
+      tryUpdateVector(vecBlock->idx());
     }
   }
 
@@ -117,9 +122,13 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
       // update all the blocks beneath
       for (size_t i = block->y() + 1; i < nbBlocksRows_; ++i) {
         size_t colBlockIdx = i * nbBlocksCols_ + block->y();
-        updateVecPending_.emplace_back(UpdateVectorIdx(colBlockIdx, block->idx(), i));
+        updateVecPending_[i].emplace(block->idx(), UpdateVectorIdx(colBlockIdx, block->idx(), i));
+        tryUpdateVector(i);
+      }
+      this->addResult(makeMessage<MatrixBlockData<T, VectorBlockPhase1>>(block));
+      if (block->y() == nbBlocksRows_ - 1) {
+        solved();
       }
-      this->addResult(std::make_shared<MatrixBlockData<T, VectorBlockPhase1>>(block));
     } else {
       vectorBlocks_[block->idx()]->decRank();
 
@@ -127,11 +136,14 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
       for (size_t i = 0; i < block->y(); ++i) {
         size_t colBlockIdx =
                 block->y() * nbBlocksCols_ + i; // we invert because the matrix should be translated
-        updateVecPending_.emplace_back(UpdateVectorIdx(colBlockIdx, block->idx(), i));
+        updateVecPending_[i].emplace(block->idx(), UpdateVectorIdx(colBlockIdx, block->idx(), i));
+        tryUpdateVector(i);
+      }
+      this->addResult(makeMessage<MatrixBlockData<T, Result>>(block));
+      if (block->y() == 0) {
+        solved();
       }
-      this->addResult(std::make_shared<MatrixBlockData<T, Result>>(block));
     }
-    sendUpdatePending();
   }
 
   /* Updated ******************************************************************/
@@ -142,48 +154,32 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
       size_t rank = vectorBlocks_[block->idx()]->incRank();
 
       if (rank == block->y()) {
-        solveDiagPending_.emplace_back(SolveDiagonalIdx(
-                block->y() * nbBlocksCols_ + block->y(),
-                block->idx()
-        ));
+        solveReady_[block->idx()] = true;
       }
     } else {
       size_t rank = vectorBlocks_[block->idx()]->decRank();
 
       if (rank == 1) {
-        solveDiagPending_.emplace_back(SolveDiagonalIdx(
-                block->y() * nbBlocksCols_ + block->y(),
-                block->idx()
-        ));
+        solveReady_[block->idx()] = true;
       }
     }
 
-    sendSolveDiagPending();
-    sendUpdatePending();
+    trySolveDiagonal(block->idx());
+    tryUpdateVector(block->idx());
   }
 
   /* idDone ******************************************************************/
 
-  [[nodiscard]] bool isDone() const {
-    if constexpr (Phase == Phases::First) {
-      return !vectorBlocks_.empty() && vectorBlocks_.back() &&
-             vectorBlocks_.back()->rank() > vectorBlocks_.back()->y();
-    } else {
-      return !vectorBlocks_.empty() && vectorBlocks_.front() && vectorBlocks_.front()->rank() == 0;
-    }
-  }
+  [[nodiscard]] bool isDone() const { return nbSolved_ == nbSolves_; }
+
+  /// @brief No more vector will be solved (called between two solves when the number of solves
+  /// was not known at construction).
+  void finishSolving() { nbSolves_ = nbSolved_; }
 
  private:
 
   /* Types *******************************************************************/
 
-  struct SolveDiagonalIdx {
-    SolveDiagonalIdx(size_t diag, size_t vec) :
-            diag(diag), vec(vec) {}
-    size_t diag; // diagonal element
-    size_t vec;  // vector element
-  };
-
   struct UpdateVectorIdx {
     UpdateVectorIdx(size_t col, size_t solvedVec, size_t updatedVec) :
             col(col), solvedVec(solvedVec), updatedVec(updatedVec) {}
@@ -194,64 +190,76 @@ class SolverState : public hh::AbstractState<SStateInNb, SStateIn, SStateOut > {
 
   /* Variables ***************************************************************/
 
-  std::vector<std::shared_ptr<MatrixBlockData<T, MatrixBlock>>> blocks_ = {};
+  std::shared_ptr<TileTable<T>> tiles_ = nullptr;
+  std::vector<bool> decomposed_ = {}; // the block of the matrix is decomposed
   std::vector<std::shared_ptr<MatrixBlockData<T, Vector>>> vectorBlocks_ = {};
-  std::list<SolveDiagonalIdx> solveDiagPending_ = {};
-  std::list<UpdateVectorIdx> updateVecPending_ = {};
+  std::vector<bool> solveReady_ = {}; // the vector block has all its updates, waits for its diagonal block
+  std::vector<std::map<size_t, UpdateVectorIdx>> updateVecPending_ = {}; // by updated and solved part
   size_t nbBlocksCols_ = 0;
   size_t nbBlocksRows_ = 0;
+  size_t nbSolves_ = 1;
+  size_t nbSolved_ = 0;
 
   /* Send functions **********************************************************/
 
-  /// @brief Send all pending triplet to update if all the blocks are ready
-  void sendUpdatePending() {
-    auto it = updateVecPending_.begin();
-
-    while (it != updateVecPending_.end()) {
-      auto col = blocks_[it->col];
-      auto solvedVec = vectorBlocks_[it->solvedVec];
-      auto updatedVec = vectorBlocks_[it->updatedVec];
-      bool isReady;
-
-      if constexpr (Phase == Phases::First) {
-        isReady = updatedVec && updatedVec->rank() == (solvedVec->rank() - 1);
-      } else {
-        isReady = updatedVec && updatedVec->rank() == (solvedVec->y() - updatedVec->y() + 1);
-      }
-
-      if (col && isReady) {
-        this->addResult(std::make_shared<UpdateVectorTaskInType<T>>(
-                std::make_shared<MatrixBlockData<T, Column>>(col),
-                solvedVec,
-                updatedVec));
-        it = updateVecPending_.erase(it);
-      } else {
-        it++;
-      }
+  /// @brief The matrix and the vector have the same number of block rows, so the first message
+  /// (matrix or vector block) allocates everything.
+  void init(size_t nbBlocks) {
+    if (nbBlocksRows_ == 0) {
+      nbBlocksCols_ = nbBlocks;
+      nbBlocksRows_ = nbBlocks;
+      tiles_->init(nbBlocks, nbBlocks);
+      decomposed_ = std::vector<bool>(nbBlocks * nbBlocks, false);
+      vectorBlocks_ = std::vector<std::shared_ptr<MatrixBlockData<T, Vector>>>(nbBlocks, nullptr);
+      solveReady_ = std::vector<bool>(nbBlocks, false);
+      updateVecPending_ = std::vector<std::map<size_t, UpdateVectorIdx>>(nbBlocks);
     }
   }
 
+  /// @brief The last vector block is solved (the block n-1 in the first phase, 0 in the second): the
+  /// matrix blocks are kept for the next vector.
+  void solved() {
+    ++nbSolved_;
+    std::fill(vectorBlocks_.begin(), vectorBlocks_.end(), nullptr);
+  }
+
+  /// @brief Sends the next update of the vector block vec if its column block is received.
+  void tryUpdateVector(size_t vec) {
+    auto updatedVec = vectorBlocks_[vec];
 
-  /// @brief Send all the pending diagonal blocks to update if they are ready
-  void sendSolveDiagPending() {
-    if (blocks_.empty()) {
+    if (!updatedVec) {
       return;
     }
+    // the vector block is updated with the solved parts in increasing order in the first phase
+    // (rank == solved part) and in decreasing order in the second one (rank == solved - vec + 1)
+    size_t solved = Phase == Phases::First ? updatedVec->rank() : updatedVec->rank() + vec - 1;
+    auto it = updateVecPending_[vec].find(solved);
+
+    if (it != updateVecPending_[vec].end() && decomposed_[it->second.col]) {
+      // the block of the table is shared with the other states, the acquired pointer is stored in
+      // a new block
+      auto col = makeMessage<MatrixBlockData<T, Column>>(tiles_->get(it->second.col));
+      col->acquire();
+      this->addResult(makeMessage<UpdateVectorTaskInType<T>>(
+              col,
+              vectorBlocks_[it->second.solvedVec],
+              updatedVec));
+      updateVecPending_[vec].erase(it);
+    }
+  }
 
-    auto it = solveDiagPending_.begin();
-
-    while (it != solveDiagPending_.end()) {
-      auto diag = blocks_[it->diag];
-      auto vec = vectorBlocks_[it->vec];
-
-      if (diag && vec) {
-        this->addResult(std::make_shared<SolveDiagonalTaskInType<T>>(
-                std::make_shared<MatrixBlockData<T, Diagonal>>(diag),
-                vec));
-        it = solveDiagPending_.erase(it);
-      } else {
-        it++;
-      }
+  /// @brief Sends the diagonal solve of the vector block vec if it has all its updates and if the
+  /// diagonal block is received.
+  void trySolveDiagonal(size_t vec) {
+    size_t diagIdx = vec * nbBlocksCols_ + vec;
+
+    if (solveReady_[vec] && decomposed_[diagIdx] && vectorBlocks_[vec]) {
+      auto diag = makeMessage<MatrixBlockData<T, Diagonal>>(tiles_->get(diagIdx));
+      solveReady_[vec] = false;
+      diag->acquire();
+      this->addResult(makeMessage<SolveDiagonalTaskInType<T>>(
+              diag,
+              vectorBlocks_[vec]));
     }
   }
 };
@@ -20,7 +20,7 @@
 #define CHOLESKY_HH_COMPUTE_COLUMN_BLOCK_TASK_H
 
 #include "hedgehog/hedgehog/hedgehog.h"
-#include <cblas.h>
+#include "../../kernels/tile_kernels.h"
 #include "../../data/matrix_block_data.h"
 
 template<typename T>
@@ -32,28 +32,40 @@ using CCBTaskInputType =
 #define CCBTaskIn CCBTaskInputType<T>
 #define CCBTaskOut MatrixBlockData<T, Column>
 
-template<typename T>
+template<typename T, typename Kernels = GenericKernels<T>>
 class ComputeColumnBlockTask : public hh::AbstractAtomicTask<CCBTaskInNb, CCBTaskIn, CCBTaskOut > {
  public:
-  explicit ComputeColumnBlockTask(size_t nbThreads)
+  /// @brief When packBlocks is set, the column blocks are sent with a packed copy that is used by
+  /// the update tasks (only useful when all the updates of the column are sent together).
+  explicit ComputeColumnBlockTask(size_t nbThreads, bool packBlocks = false)
           : hh::AbstractAtomicTask<CCBTaskInNb, CCBTaskIn, CCBTaskOut >(
-          "Compute Column Block Task", nbThreads) {}
+          "Compute Column Block Task", nbThreads), packBlocks_(packBlocks) {}
 
   /// @brief Receives a pair of blocks. The first block is a the diagonal element on the column and
   /// the second block is the one that will be updated $(colB = colB(diagB^T)^{-1})$.
   void execute(std::shared_ptr<CCBTaskInputType<T>> blocks) override {
     auto diagBlock = blocks->first;
     auto colBlock = blocks->second;
-    // todo: leading dimension should be configurable
-    cblas_dtrsm(CblasRowMajor, CblasRight, CblasLower, CblasTrans, CblasNonUnit,
-                colBlock->height(), colBlock->width(), 1.0, diagBlock->get(),
-                diagBlock->matrixWidth(), colBlock->get(), colBlock->matrixWidth());
-    this->addResult(std::make_shared<MatrixBlockData<T, Column>>(std::move(colBlock)));
+    Kernels::trsm(colBlock->height(), colBlock->width(), diagBlock->get(), diagBlock->ld(),
+                  colBlock->get(), colBlock->ld());
+    std::shared_ptr<T[]> packed = nullptr;
+    // the blocks of the last row only update their diagonal block (syrk), the copy would not be used
+    if (packBlocks_ && colBlock->y() + 1 < colBlock->nbBlocksRows()) {
+      packed = Kernels::pack(colBlock->height(), colBlock->width(), colBlock->get(), colBlock->ld());
+    }
+    diagBlock->release();
+    colBlock->release(true, true);
+    auto column = makeMessage<MatrixBlockData<T, Column>>(std::move(colBlock));
+    column->packed(std::move(packed));
+    this->addResult(column);
   }
 
   std::shared_ptr<hh::AbstractTask<CCBTaskInNb, CCBTaskIn, CCBTaskOut>> copy() override {
-    return std::make_shared<ComputeColumnBlockTask<T>>(this->numberThreads());
+    return std::make_shared<ComputeColumnBlockTask<T, Kernels>>(this->numberThreads(), packBlocks_);
   }
+
+ private:
+  bool packBlocks_ = false;
 };
 
 #endif //CHOLESKY_HH_COMPUTE_COLUMN_BLOCK_TASK_H
@@ -20,32 +20,48 @@
 #define CHOLESKY_HH_COMPUTE_DIAGONAL_BLOCK_TASK_H
 
 #include "hedgehog/hedgehog/hedgehog.h"
-#include <lapack.h>
+#include "../../kernels/tile_kernels.h"
+#include "../../kernels/parallel_potrf.h"
 #include "../../data/matrix_block_data.h"
 
 #define CDBTaskInNb 1
 #define CDBTaskIn MatrixBlockData<T, Diagonal>
 #define CDBTaskOut MatrixBlockData<T, Diagonal>
 
-template<typename T>
+/// @brief Factorizes the diagonal blocks with the potrf kernel of the policy Kernels. The diagonal
+/// blocks are on the critical path of the decomposition, so with nbThreadsFactor > 1, each thread
+/// of the task factorizes the large blocks with parallelPotrf on its own group of nbThreadsFactor
+/// threads (the calling thread included).
+template<typename T, typename Kernels = GenericKernels<T>>
 class ComputeDiagonalBlockTask : public hh::AbstractAtomicTask<CDBTaskInNb, CDBTaskIn, CDBTaskOut > {
  public:
-  explicit ComputeDiagonalBlockTask(size_t nbThreads) :
-          hh::AbstractAtomicTask<CDBTaskInNb, CDBTaskIn, CDBTaskOut >("Compute Diagonal Block Task", nbThreads) {}
+  explicit ComputeDiagonalBlockTask(size_t nbThreads, size_t nbThreadsFactor = 1) :
+          hh::AbstractAtomicTask<CDBTaskInNb, CDBTaskIn, CDBTaskOut >("Compute Diagonal Block Task", nbThreads),
+          nbThreadsFactor_(nbThreadsFactor) {}
+
+  void initialize() override {
+    if (nbThreadsFactor_ > 1) {
+      group_ = std::make_unique<ThreadGroup>(nbThreadsFactor_);
+    }
+  }
 
   void execute(std::shared_ptr<MatrixBlockData<T, Diagonal>> block) override {
-    int32_t n = block->height();
-    // todo: leading dimension should be configurable
-    int32_t lda = block->matrixWidth();
-    int32_t info = 0;
-    /* LAPACK_dpotf2((char*) "U", &n, block->get(), &lda, &info); */
-    LAPACK_dpotrf((char*) "U", &n, block->get(), &lda, &info);
+    if (group_ && block->height() > ParallelPotrfLeaf) {
+      parallelPotrf<Kernels>(block->height(), block->get(), block->ld(), *group_);
+    } else {
+      Kernels::potrf(block->height(), block->get(), block->ld());
+    }
+    block->release(true, true);
     this->addResult(block);
   }
 
   std::shared_ptr<hh::AbstractTask<CDBTaskInNb, CDBTaskIn, CDBTaskOut>> copy() override {
-    return std::make_shared<ComputeDiagonalBlockTask<T>>(this->numberThreads());
+    return std::make_shared<ComputeDiagonalBlockTask<T, Kernels>>(this->numberThreads(), nbThreadsFactor_);
   }
+
+ private:
+  size_t nbThreadsFactor_ = 1;
+  std::unique_ptr<ThreadGroup> group_ = nullptr;
 };
 
 #endif //CHOLESKY_HH_COMPUTE_DIAGONAL_BLOCK_TASK_H
@@ -26,9 +26,11 @@
 
 #define SMTaskInNb 2
 #define SMTaskIn MatrixData<T, MatrixTypes::Matrix>, MatrixData<T, MatrixTypes::Vector>
-#define SMTaskOut MatrixBlockData<T, MatrixBlock>, MatrixBlockData<T, VectorBlock>
+#define SMTaskOut MatrixBlockData<T, MatrixBlockType>, MatrixBlockData<T, VectorBlock>
 
-template <typename T>
+/// @brief Splits the matrix and the vector in blocks. The matrix blocks are sent with the type
+/// MatrixBlockType (Decomposed when the matrix is already factorized).
+template <typename T, BlockTypes MatrixBlockType = MatrixBlock>
 class SplitMatrixTask
         : public hh::AbstractAtomicTask<SMTaskInNb, SMTaskIn, SMTaskOut > {
  public:
@@ -39,13 +41,15 @@ class SplitMatrixTask
   void execute(std::shared_ptr<MatrixData<T, MatrixTypes::Matrix>> matrix) override {
     for (size_t iBlock = 0; iBlock < matrix->nbBlocksRows(); ++iBlock) {
       for (size_t jBlock = 0; jBlock <= iBlock; ++jBlock) {
-        this->addResult(std::make_shared<MatrixBlockData<T, MatrixBlock>>(
+        // out-of-core: the blocks are loaded by the states when they are acquired
+        auto block = std::make_shared<MatrixBlockData<T, MatrixBlockType>>(
                 std::min(matrix->blockSize(), matrix->width() - (jBlock * matrix->blockSize())),
                 std::min(matrix->blockSize(), matrix->height() - (iBlock * matrix->blockSize())),
                 matrix->nbBlocksRows(), matrix->nbBlocksCols(),
-                jBlock, iBlock, matrix->width(), matrix->height(),
-                matrix->get() + iBlock * matrix->blockSize() * matrix->width() +
-                jBlock * matrix->blockSize(), matrix->get()));
+                jBlock, iBlock, matrix->width(), matrix->height(), matrix->blockLd(),
+                matrix->cache() ? nullptr : matrix->blockPtr(iBlock, jBlock), matrix->get());
+        block->cache(matrix->cache());
+        this->addResult(block);
       }
     }
   }
@@ -56,8 +60,7 @@ class SplitMatrixTask
               1,
               std::min(vector->blockSize(), vector->height() - (iBlock * vector->blockSize())),
               vector->nbBlocksRows(), vector->nbBlocksCols(), 0, iBlock, vector->width(),
-              vector->height(), vector->get() + iBlock * vector->blockSize() * vector->width(),
-              vector->get()));
+              vector->height(), vector->blockLd(), vector->blockPtr(iBlock, 0), vector->get()));
     }
   }
 };
@@ -0,0 +1,89 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_STREAM_MATRIX_TASK_H
+#define CHOLESKY_HH_STREAM_MATRIX_TASK_H
+
+#include "hedgehog/hedgehog/hedgehog.h"
+#include <fcntl.h>
+#include <memory>
+#include <vector>
+#include "../../data/matrix_block_data.h"
+#include "../../data/matrix_stream_data.h"
+#include "../../io/file_io.h"
+#include "../../io/packed_format.h"
+#include "../../io/parallel_loader.h"
+
+#define STMTaskInNb 1
+#define STMTaskIn MatrixStreamData<T>
+#define STMTaskOut MatrixBlockData<T, MatrixBlock>
+
+/// @brief Reads the matrix from the input file tile row by tile row and sends the blocks of a tile
+/// row as soon as it is loaded, so the decomposition starts while the rest of the file is read.
+template <typename T>
+class StreamMatrixTask
+        : public hh::AbstractAtomicTask<STMTaskInNb, STMTaskIn, STMTaskOut > {
+ public:
+  StreamMatrixTask()
+          : hh::AbstractAtomicTask<STMTaskInNb, STMTaskIn, STMTaskOut >("Stream matrix task") {
+  }
+
+  void execute(std::shared_ptr<MatrixStreamData<T>> stream) override {
+    auto matrix = stream->matrix;
+    PackedLayout layout(matrix->height(), matrix->blockSize());
+    std::vector<T> tileRow;
+    int fd = open(stream->fileName.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+      throw std::runtime_error("cannot open " + stream->fileName);
+    }
+    FileDescriptorGuard guard(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    for (size_t iBlock = 0; iBlock < matrix->nbBlocksRows(); ++iBlock) {
+      if (stream->packed) {
+        tileRow.resize(layout.tileRowSize(iBlock));
+        readFully(fd, tileRow.data(), tileRow.size() * sizeof(T),
+                  stream->matrixOffset + layout.tileRowOffset(iBlock) * sizeof(T));
+        unpackTileRow(layout, iBlock, tileRow.data(), *matrix);
+      } else if (matrix->layout() == MatrixLayouts::RowMajor) {
+        size_t rowOffset = iBlock * matrix->blockSize() * matrix->width();
+        readFully(fd, matrix->get() + rowOffset,
+                  layout.tileHeight(iBlock) * matrix->width() * sizeof(T),
+                  stream->matrixOffset + rowOffset * sizeof(T));
+      } else {
+        size_t rowOffset = iBlock * matrix->blockSize() * matrix->width();
+        tileRow.resize(layout.tileHeight(iBlock) * matrix->width());
+        readFully(fd, tileRow.data(), tileRow.size() * sizeof(T),
+                  stream->matrixOffset + rowOffset * sizeof(T));
+        copyTileRow(*matrix, iBlock, tileRow.data(), iBlock);
+      }
+
+      for (size_t jBlock = 0; jBlock <= iBlock; ++jBlock) {
+        this->addResult(std::make_shared<MatrixBlockData<T, MatrixBlock>>(
+                std::min(matrix->blockSize(), matrix->width() - (jBlock * matrix->blockSize())),
+                std::min(matrix->blockSize(), matrix->height() - (iBlock * matrix->blockSize())),
+                matrix->nbBlocksRows(), matrix->nbBlocksCols(),
+                jBlock, iBlock, matrix->width(), matrix->height(), matrix->blockLd(),
+                matrix->blockPtr(iBlock, jBlock), matrix->get()));
+      }
+    }
+  }
+};
+
+#endif //CHOLESKY_HH_STREAM_MATRIX_TASK_H
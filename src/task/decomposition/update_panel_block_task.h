@@ -0,0 +1,93 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_UPDATE_PANEL_BLOCK_TASK_H
+#define CHOLESKY_HH_UPDATE_PANEL_BLOCK_TASK_H
+
+#include "hedgehog/hedgehog/hedgehog.h"
+#include "../../kernels/tile_kernels.h"
+#include "../../data/matrix_block_data.h"
+#include "../../data/panel_update_data.h"
+
+#define UPBTaskInNb 1
+#define UPBTaskIn PanelUpdateData<T>
+#define UPBTaskOut MatrixBlockData<T, Updated>
+
+/// @brief Left looking update: applies all the updates of a block with one call. When the blocks of
+/// the rows are contiguous (row major matrix), the k range of the rows is concatenated, so a single
+/// gemm (or syrk on the diagonal) of size m x n x (j.blockSize) is done instead of j small ones.
+template <typename T, typename Kernels = GenericKernels<T>>
+class UpdatePanelBlockTask
+        : public hh::AbstractAtomicTask<UPBTaskInNb, UPBTaskIn, UPBTaskOut > {
+ public:
+  explicit UpdatePanelBlockTask(size_t nbThreads) :
+          hh::AbstractAtomicTask<UPBTaskInNb, UPBTaskIn, UPBTaskOut >("Update Panel Block Task",
+                                                                      nbThreads) {}
+
+  void execute(std::shared_ptr<PanelUpdateData<T>> data) override {
+    auto updated = data->updated;
+    auto row1 = [&data](size_t k) { return data->row1(k); };
+    auto row2 = [&data](size_t k) { return data->row2(k); };
+    size_t size = data->size();
+
+    if (isContiguous(size, row1) && isContiguous(size, row2)) {
+      update(row1(0), row2(0), updated, size * row1(0)->width());
+    } else {
+      for (size_t k = 0; k < size; ++k) {
+        auto col1 = row1(k);
+        update(col1, row2(k), updated, col1->width());
+      }
+    }
+    this->addResult(makeMessage<MatrixBlockData<T, Updated>>(std::move(updated)));
+  }
+
+  std::shared_ptr<hh::AbstractTask<UPBTaskInNb, UPBTaskIn, UPBTaskOut>> copy() override {
+    return std::make_shared<UpdatePanelBlockTask<T, Kernels>>(this->numberThreads());
+  }
+
+ private:
+  /// @brief True when the size blocks of the row (row(k) gives the block k) follow each other in
+  /// memory with the same ld.
+  template <typename Row>
+  static bool isContiguous(size_t size, Row const &row) {
+    auto previous = row(0);
+
+    for (size_t k = 1; k < size; ++k) {
+      auto block = row(k);
+      if (block->get() != previous->get() + previous->width() || block->ld() != previous->ld()) {
+        return false;
+      }
+      previous = std::move(block);
+    }
+    return true;
+  }
+
+  /// @brief updated = updated - col1.col2^T where col1 and col2 have k columns.
+  static void update(std::shared_ptr<MatrixBlockData<T, MatrixBlock>> const &col1,
+                     std::shared_ptr<MatrixBlockData<T, MatrixBlock>> const &col2,
+                     std::shared_ptr<MatrixBlockData<T, MatrixBlock>> const &updated, size_t k) {
+    if (updated->x() == updated->y()) {
+      Kernels::syrk(updated->height(), k, col1->get(), col1->ld(), updated->get(), updated->ld());
+    } else {
+      Kernels::gemm(updated->height(), updated->width(), k, col1->get(), col1->ld(), col2->get(),
+                    col2->ld(), updated->get(), updated->ld());
+    }
+  }
+};
+
+#endif //CHOLESKY_HH_UPDATE_PANEL_BLOCK_TASK_H
@@ -20,9 +20,10 @@
 #define CHOLESKY_HH_UPDATE_SUBMATRIX_BLOCK_TASK_H
 
 #include "hedgehog/hedgehog/hedgehog.h"
-#include <cblas.h>
+#include "../../kernels/tile_kernels.h"
 #include "../../data/matrix_block_data.h"
 #include "../../data/triple_block_data.h"
+#include "../../memory/numa.h"
 
 template <typename T>
 using UpdateSubmatrixBlockInputType = TripleBlockData<T>;
@@ -31,34 +32,54 @@ using UpdateSubmatrixBlockInputType = TripleBlockData<T>;
 #define USBTaskIn UpdateSubmatrixBlockInputType<T>
 #define USBTaskOut MatrixBlockData<T, Updated>
 
-template <typename T>
+template <typename T, typename Kernels = GenericKernels<T>>
 class UpdateSubMatrixBlockTask
         : public hh::AbstractAtomicTask<USBTaskInNb, USBTaskIn, USBTaskOut > {
  public:
-  explicit UpdateSubMatrixBlockTask(size_t nbThreads) :
+  explicit UpdateSubMatrixBlockTask(size_t nbThreads,
+                                    std::shared_ptr<NumaPlacement> placement = nullptr) :
           hh::AbstractAtomicTask<USBTaskInNb, USBTaskIn, USBTaskOut >("Update Submatrix Block Task",
-                                                                      nbThreads) {}
+                                                                      nbThreads),
+          placement_(placement) {}
+
+  /// @brief With a NUMA placement, the task runs in the copy of the update graph of a node (see
+  /// UpdateSubMatrixExecutionPipeline, the device id is the node), and its threads run on this node.
+  void initialize() override {
+    if (placement_) {
+      placement_->topology().bindCurrentThread(this->deviceId());
+    }
+  }
 
   /// @brief Receives 3 blocks. The first two blocks are on the column that is processed. The third
-  /// block will be updated. Here we do $updatedB = updatedB - colB1.colB2^T$.
+  /// block will be updated. Here we do $updatedB = updatedB - colB1.colB2^T$ (syrk on the diagonal).
   void execute(std::shared_ptr<UpdateSubmatrixBlockInputType<T>> blocks) override {
     auto colBlock1 = blocks->first;
     auto colBlock2 = blocks->second;
     auto updatedBlock = blocks->third;
-    size_t m = updatedBlock->height();
-    size_t n = updatedBlock->width();
-    size_t k = colBlock1->width();
-    // todo: the leading dimension should be configurable
-    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, m, n, k, -1.0, colBlock1->get(),
-                colBlock1->matrixWidth(), colBlock2->get(), colBlock2->matrixWidth(), 1.0,
-                updatedBlock->get(), updatedBlock->matrixWidth());
-    this->addResult(std::make_shared<MatrixBlockData<T, Updated>>(std::move(updatedBlock)));
+
+    if (updatedBlock->x() == updatedBlock->y()) {
+      // diagonal target: colB1 == colB2 and only the lower part is used by the decomposition
+      Kernels::syrk(updatedBlock->height(), colBlock1->width(), colBlock1->get(), colBlock1->ld(),
+                    updatedBlock->get(), updatedBlock->ld());
+    } else {
+      // uses the packed copy of colB2 made by the column task when there is one
+      Kernels::gemmPacked(updatedBlock->height(), updatedBlock->width(), colBlock1->width(),
+                          colBlock1->get(), colBlock1->ld(), colBlock2->get(), colBlock2->ld(),
+                          blocks->packedSecond.get(), updatedBlock->get(), updatedBlock->ld());
+    }
+    colBlock1->release();
+    colBlock2->release();
+    updatedBlock->release(true);
+    this->addResult(makeMessage<MatrixBlockData<T, Updated>>(std::move(updatedBlock)));
   }
 
   std::shared_ptr<hh::AbstractTask<USBTaskInNb, USBTaskIn, USBTaskOut >>
   copy() override {
-    return std::make_shared<UpdateSubMatrixBlockTask<T>>(this->numberThreads());
+    return std::make_shared<UpdateSubMatrixBlockTask<T, Kernels>>(this->numberThreads(), placement_);
   }
+
+ private:
+  std::shared_ptr<NumaPlacement> placement_ = nullptr;
 };
 
 #endif //CHOLESKY_HH_UPDATE_SUBMATRIX_BLOCK_TASK_H
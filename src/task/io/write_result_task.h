@@ -0,0 +1,58 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_WRITE_RESULT_TASK_H
+#define CHOLESKY_HH_WRITE_RESULT_TASK_H
+
+#include "hedgehog/hedgehog/hedgehog.h"
+#include <memory>
+#include "../../data/matrix_block_data.h"
+#include "../../io/result_writer.h"
+
+#define WRTaskInNb 2
+#define WRTaskIn MatrixBlockData<T, Decomposed>, MatrixBlockData<T, Result>
+#define WRTaskOut MatrixBlockData<T, Result>
+
+/// @brief Sink of the graph: writes the tiles of L and the blocks of the solution in the output
+/// file as soon as they are final, so the output overlaps with the rest of the computation.
+template <typename T>
+class WriteResultTask : public hh::AbstractAtomicTask<WRTaskInNb, WRTaskIn, WRTaskOut > {
+ public:
+  explicit WriteResultTask(std::shared_ptr<ResultWriter<T>> writer, size_t nbThreads = 1)
+          : hh::AbstractAtomicTask<WRTaskInNb, WRTaskIn, WRTaskOut >("Write Result Task", nbThreads),
+            writer_(writer) {}
+
+  void execute(std::shared_ptr<MatrixBlockData<T, Decomposed>> block) override {
+    block->acquire(); // out-of-core mode: the tile may have been evicted
+    writer_->writeTile(block->y(), block->x(), block->get(), block->ld());
+    block->release();
+  }
+
+  void execute(std::shared_ptr<MatrixBlockData<T, Result>> block) override {
+    writer_->writeVector(block->y(), block->get(), block->height());
+  }
+
+  std::shared_ptr<hh::AbstractTask<WRTaskInNb, WRTaskIn, WRTaskOut>> copy() override {
+    return std::make_shared<WriteResultTask<T>>(writer_, this->numberThreads());
+  }
+
+ private:
+  std::shared_ptr<ResultWriter<T>> writer_ = nullptr;
+};
+
+#endif //CHOLESKY_HH_WRITE_RESULT_TASK_H
@@ -21,7 +21,7 @@
 #include "../../data/matrix_block_data.h"
 #include "../../data/solver/phases.h"
 #include <hedgehog/hedgehog.h>
-#include <cblas.h>
+#include "../../kernels/blas.h"
 
 template <typename T>
 using SolveDiagonalTaskInType =
@@ -42,16 +42,16 @@ class SolveDiagonalTask : public hh::AbstractTask<SDTaskInNb, SDTaskIn, SDTaskOu
   void execute(std::shared_ptr<SolveDiagonalTaskInType<T>> blocks) override {
     auto diagBlock = blocks->first;
     auto vecBlock = blocks->second;
-    // todo: leading dimension should be configurable
     if constexpr (Phase == Phases::First) {
-      cblas_dtrsm(CblasRowMajor, CblasLeft, CblasLower, CblasNoTrans, CblasNonUnit,
-                  vecBlock->height(), vecBlock->width(), 1.0, diagBlock->get(),
-                  diagBlock->matrixWidth(), vecBlock->get(), vecBlock->matrixWidth());
+      blas::trsm(CblasLeft, CblasLower, CblasNoTrans, CblasNonUnit,
+                 vecBlock->height(), vecBlock->width(), 1.0, diagBlock->get(),
+                 diagBlock->ld(), vecBlock->get(), vecBlock->ld());
     } else {
-      cblas_dtrsm(CblasRowMajor, CblasLeft, CblasLower, CblasTrans, CblasNonUnit,
-                  vecBlock->height(), vecBlock->width(), 1.0, diagBlock->get(),
-                  diagBlock->matrixWidth(), vecBlock->get(), vecBlock->matrixWidth());
+      blas::trsm(CblasLeft, CblasLower, CblasTrans, CblasNonUnit,
+                 vecBlock->height(), vecBlock->width(), 1.0, diagBlock->get(),
+                 diagBlock->ld(), vecBlock->get(), vecBlock->ld());
     }
+    diagBlock->release();
     this->addResult(vecBlock);
   }
 
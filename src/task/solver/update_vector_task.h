@@ -22,7 +22,7 @@
 #include "../../data/triple_block_data.h"
 #include "../../data/solver/phases.h"
 #include <hedgehog/hedgehog.h>
-#include <cblas.h>
+#include "../../kernels/blas.h"
 
 template <typename T>
 using UpdateVectorTaskInType = TripleBlockData<T, Column, Vector, Vector>;
@@ -47,17 +47,17 @@ class UpdateVectorTask : public hh::AbstractTask<UVTaskInNb, UVTaskIn, UVTaskOut
     size_t m = updatedBlock->height();
     size_t n = updatedBlock->width();
     size_t k = solvedVectorBlock->height();
-    // todo: the leading dimension should be configurable
     if constexpr (Phase == Phases::First) {
-      cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, -1.0, colBlock->get(),
-                  colBlock->matrixWidth(), solvedVectorBlock->get(), solvedVectorBlock->matrixWidth(), 1.0,
-                  updatedBlock->get(), updatedBlock->matrixWidth());
+      blas::gemm(CblasNoTrans, CblasNoTrans, m, n, k, -1.0, colBlock->get(),
+                 colBlock->ld(), solvedVectorBlock->get(), solvedVectorBlock->ld(), 1.0,
+                 updatedBlock->get(), updatedBlock->ld());
     } else {
-      cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, m, n, k, -1.0, colBlock->get(),
-                  colBlock->matrixWidth(), solvedVectorBlock->get(), solvedVectorBlock->matrixWidth(), 1.0,
-                  updatedBlock->get(), updatedBlock->matrixWidth());
+      blas::gemm(CblasTrans, CblasNoTrans, m, n, k, -1.0, colBlock->get(),
+                 colBlock->ld(), solvedVectorBlock->get(), solvedVectorBlock->ld(), 1.0,
+                 updatedBlock->get(), updatedBlock->ld());
     }
-    this->addResult(std::make_shared<MatrixBlockData<T, Updated>>(updatedBlock));
+    colBlock->release();
+    this->addResult(makeMessage<MatrixBlockData<T, Updated>>(updatedBlock));
   }
 
   std::shared_ptr<hh::AbstractTask<UVTaskInNb, UVTaskIn, UVTaskOut>>
@@ -0,0 +1,266 @@
+// NIST-developed software is provided by NIST as a public service. You may use, copy and distribute copies of the
+// software in any medium, provided that you keep intact this entire notice. You may improve, modify and create
+// derivative works of the software or any portion of the software, and you may copy and distribute such modifications
+// or works. Modified works should carry a notice stating that you changed the software and should note the date and
+// nature of any such change. Please explicitly acknowledge the National Institute of Standards and Technology as the
+// source of the software. NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY OF ANY KIND,
+// EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+// WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE
+// CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS
+// THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE. You
+// are solely responsible for determining the appropriateness of using and distributing the software and you assume
+// all risks associated with its use, including but not limited to the risks and costs of program errors, compliance
+// with applicable laws, damage to or loss of data, programs or equipment, and the unavailability or interruption of
+// operation. This software is not intended to be used in any situation where a failure could cause risk of injury or
+// damage to property. The software developed by NIST employees is not subject to copyright protection within the
+// United States.
+
+#ifndef CHOLESKY_HH_TUNING_H
+#define CHOLESKY_HH_TUNING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "config.h"
+#include "io/mapped_file.h"
+#include "io/packed_format.h"
+#include "kernels/tile_kernels.h"
+
+/// Block size autotuner (--autotune): the tile kernels are measured on the current machine for each
+/// candidate block size, the time of the decomposition is estimated for the size of the matrix and
+/// the number of threads, and the fastest block size is used. The measures and the choices are
+/// stored in a tuning file, so the next runs reuse them:
+///   kernels <type> <blockSize> <potrf> <trsm> <gemm> <syrk>   (microseconds per call)
+///   choice <type> <size> <threads> <blockSize>
+/// The file has to be removed when the program runs on another machine.
+
+constexpr size_t AutotuneBlockSizes[] = {16, 32, 64, 128, 256, 512};
+
+/// @brief Approximate cost of a task in the graph (message sent by a state, queue, execution).
+constexpr double TaskOverhead = 5.;
+
+/// @brief Time of the kernels on full tiles in microseconds.
+struct KernelTimes {
+  double potrf = 0;
+  double trsm = 0;
+  double gemm = 0;
+  double syrk = 0;
+};
+
+/// @brief Kernel measures and block size choices stored in the tuning file.
+class TuningFile {
+ public:
+  explicit TuningFile(std::string fileName) : fileName_(std::move(fileName)) {
+    std::ifstream fs(fileName_);
+    std::string line;
+
+    while (std::getline(fs, line)) {
+      std::istringstream iss(line);
+      std::string entry, type;
+      size_t blockSize = 0, size = 0, threads = 0;
+      KernelTimes times;
+
+      if (!(iss >> entry >> type)) {
+        continue;
+      }
+      if (entry == "kernels" && iss >> blockSize >> times.potrf >> times.trsm >> times.gemm >> times.syrk) {
+        kernels_[{type, blockSize}] = times;
+      } else if (entry == "choice" && iss >> size >> threads >> blockSize) {
+        choices_[{type, size, threads}] = blockSize;
+      }
+    }
+  }
+
+  [[nodiscard]] std::string const &fileName() const { return fileName_; }
+
+  [[nodiscard]] std::optional<KernelTimes> kernels(std::string const &type, size_t blockSize) const {
+    auto it = kernels_.find({type, blockSize});
+    return it == kernels_.end() ? std::nullopt : std::optional<KernelTimes>(it->second);
+  }
+
+  [[nodiscard]] std::optional<size_t> choice(std::string const &type, size_t size, size_t threads) const {
+    auto it = choices_.find({type, size, threads});
+    return it == choices_.end() ? std::nullopt : std::optional<size_t>(it->second);
+  }
+
+  void kernels(std::string const &type, size_t blockSize, KernelTimes const &times) {
+    kernels_[{type, blockSize}] = times;
+    append("kernels " + type + " " + std::to_string(blockSize) + " " + std::to_string(times.potrf) + " "
+           + std::to_string(times.trsm) + " " + std::to_string(times.gemm) + " " + std::to_string(times.syrk));
+  }
+
+  void choice(std::string const &type, size_t size, size_t threads, size_t blockSize) {
+    choices_[{type, size, threads}] = blockSize;
+    append("choice " + type + " " + std::to_string(size) + " " + std::to_string(threads) + " "
+           + std::to_string(blockSize));
+  }
+
+ private:
+  std::string fileName_;
+  std::map<std::tuple<std::string, size_t>, KernelTimes> kernels_ = {};
+  std::map<std::tuple<std::string, size_t, size_t>, size_t> choices_ = {};
+
+  /// @brief The entries are appended, a tuning file that cannot be written only disables the cache.
+  void append(std::string const &line) {
+    std::ofstream fs(fileName_, std::ios::app);
+
+    if (!(fs << line << std::endl)) {
+      std::cerr << "warning: cannot write the tuning file " << fileName_ << std::endl;
+    }
+  }
+};
+
+/// @brief Best time per call of function in microseconds, prepare is called before each call and is
+/// not measured.
+template <typename Prepare, typename Function>
+double measureKernel(size_t nbCalls, Prepare &&prepare, Function &&function) {
+  double best = std::numeric_limits<double>::max();
+
+  for (size_t measure = 0; measure < 3; ++measure) {
+    double total = 0;
+
+    for (size_t call = 0; call < nbCalls; ++call) {
+      prepare();
+      auto begin = std::chrono::steady_clock::now();
+      function();
+      auto end = std::chrono::steady_clock::now();
+      total += std::chrono::duration<double, std::micro>(end - begin).count();
+    }
+    best = std::min(best, total / (double) nbCalls);
+  }
+  return best;
+}
+
+/// @brief Measures the kernels used by the decomposition for the block size b (same policy as
+/// withTileKernels, tiles stored with ld = b).
+template <typename T>
+KernelTimes measureKernels(size_t b) {
+  std::mt19937 generator(b);
+  std::uniform_real_distribution<T> distribution(-1, 1);
+  std::vector<T> x(b * b), y(b * b), c(b * b), spd(b * b), l, work(b * b);
+  size_t nbCalls = std::max<size_t>(1, (size_t(1) << 22) / (b * b * b));
+  KernelTimes times;
+
+  for (auto *tile : {&x, &y, &c}) {
+    for (auto &value : *tile) {
+      value = distribution(generator);
+    }
+  }
+  // spd = x.x^T + b.I, l is its factor
+  for (size_t i = 0; i < b; ++i) {
+    for (size_t j = 0; j < b; ++j) {
+      spd[i * b + j] = i == j ? T(b) : T(0);
+    }
+  }
+  blas::gemm(CblasNoTrans, CblasTrans, (int32_t) b, (int32_t) b, (int32_t) b, T(1), x.data(),
+             (int32_t) b, x.data(), (int32_t) b, T(1), spd.data(), (int32_t) b);
+  l = spd;
+  GenericKernels<T>::potrf(b, l.data(), b);
+
+  withTileKernels<T>(b, [&]<typename Kernels>(Kernels) {
+    auto panels = Kernels::pack(b, b, y.data(), b);
+
+    times.potrf = measureKernel(nbCalls, [&]() { work = spd; },
+                                [&]() { Kernels::potrf(b, work.data(), b); });
+    times.trsm = measureKernel(nbCalls, [&]() { work = y; },
+                               [&]() { Kernels::trsm(b, b, l.data(), b, work.data(), b); });
+    times.gemm = measureKernel(nbCalls, [&]() { work = c; }, [&]() {
+      Kernels::gemmPacked(b, b, b, x.data(), b, y.data(), b, panels.get(), work.data(), b);
+    });
+    times.syrk = measureKernel(nbCalls, [&]() { work = c; },
+                               [&]() { Kernels::syrk(b, b, x.data(), b, work.data(), b); });
+  });
+  return times;
+}
+
+/// @brief Estimated time of the decomposition of a size x size matrix with nbThreads threads: the
+/// work is shared by the threads but each column waits for the potrf, trsm and syrk of the
+/// previous one (critical path).
+inline double modelDecomposition(size_t size, size_t blockSize, size_t nbThreads, KernelTimes const &times) {
+  double nb = std::ceil((double) size / (double) blockSize);
+  double nbColumnTiles = nb * (nb - 1) / 2;
+  double nbGemmTiles = nb * (nb - 1) * (nb - 2) / 6;
+  double work = nb * (times.potrf + TaskOverhead)
+                + nbColumnTiles * (times.trsm + times.syrk + 2 * TaskOverhead)
+                + nbGemmTiles * (times.gemm + TaskOverhead);
+  double criticalPath = nb * (times.potrf + times.trsm + times.syrk + 3 * TaskOverhead);
+
+  return std::max(work / (double) nbThreads, criticalPath);
+}
+
+/// @brief Size of the matrix stored in the input file (packed or not).
+inline size_t inputMatrixSize(std::string const &inputFile) {
+  MappedFile file(inputFile);
+
+  if (isPackedFile(file)) {
+    return file.at<PackedHeader>(0)->size;
+  }
+  if (file.size() < 2 * sizeof(size_t)) {
+    throw std::runtime_error("invalid input file " + inputFile);
+  }
+  return *file.at<size_t>(sizeof(size_t));
+}
+
+/// @brief Chooses the block size of the decomposition with the scalar type T (see above).
+template <typename T>
+size_t autotuneBlockSize(Config const &config, std::string const &type) {
+  {
+    MappedFile file(config.inputFile);
+
+    // packed files can only be streamed or used out-of-core with the block size of the conversion
+    if (isPackedFile(file) && (config.stream || !config.tileFile.empty())) {
+      return file.at<PackedHeader>(0)->blockSize;
+    }
+  }
+  size_t size = inputMatrixSize(config.inputFile);
+  size_t nbThreads = config.threadsConfig.nbThreadsComputeDiagonalTask
+                     + config.threadsConfig.nbThreadsComputeColumnTask
+                     + config.threadsConfig.nbThreadsUpdateTask;
+  TuningFile tuningFile(config.tuningFile);
+
+  if (auto blockSize = tuningFile.choice(type, size, nbThreads)) {
+    return *blockSize;
+  }
+  size_t bestBlockSize = std::min(size, AutotuneBlockSizes[0]);
+  double bestTime = std::numeric_limits<double>::max();
+
+  for (size_t blockSize : AutotuneBlockSizes) {
+    if (blockSize > size) {
+      break;
+    }
+    auto times = tuningFile.kernels(type, blockSize);
+    if (!times) {
+      times = measureKernels<T>(blockSize);
+      tuningFile.kernels(type, blockSize, *times);
+    }
+    double time = modelDecomposition(size, blockSize, nbThreads, *times);
+    if (time < bestTime) {
+      bestTime = time;
+      bestBlockSize = blockSize;
+    }
+  }
+  tuningFile.choice(type, size, nbThreads, bestBlockSize);
+  return bestBlockSize;
+}
+
+/// @brief Block size chosen by the autotuner for the precision of the configuration (the mixed
+/// precision factorizes the matrix in float).
+inline size_t autotuneBlockSize(Config const &config) {
+  if (config.precision == Precisions::Double) {
+    return autotuneBlockSize<double>(config, "double");
+  }
+  return autotuneBlockSize<float>(config, "float");
+}
+
+#endif //CHOLESKY_HH_TUNING_H
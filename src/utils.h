@@ -21,9 +21,16 @@
 #define TESTING
 
 #include "data/matrix_data.h"
+#include "data/matrix_stream_data.h"
+#include "io/mapped_file.h"
+#include "io/packed_format.h"
+#include "io/parallel_loader.h"
+#include "memory/numa.h"
+#include "memory/tile_cache.h"
 #include "config.h"
-#include <fstream>
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include <cstddef>
 #include <cstring>
 #include <iostream>
@@ -56,75 +63,334 @@ struct Problem {
   Vector baseResult = nullptr;
   Matrix expectedMatrix = nullptr;
   Vector expectedSolution = nullptr;
+
+  // set when the matrix is read by the graph (the matrix buffer is not filled by initMatrix)
+  std::shared_ptr<MatrixStreamData<T>> stream = nullptr;
+
+  // the buffers are either allocated in the arena or views on the file mappings
+  std::shared_ptr<Arena> arena = nullptr;
+  std::shared_ptr<MappedFile> inputFile = nullptr; // read only (base and expected values)
+  std::shared_ptr<MappedFile> workFile = nullptr;  // copy-on-write (matrix and result)
+  std::shared_ptr<MappedFile> tileFile = nullptr;  // out-of-core result (see syncOutOfCore)
 };
 
+/// @brief Loads the problem by mapping the input file. The matrix and the result vector are
+/// built on a private copy-on-write mapping, so the factorization can run in place while the
+/// saved and expected values stay views on the read only mapping of the file.
+/// File format: width, height (size_t), matrix, result vector, expected triangular matrix and
+/// expected solution vector (T, row major).
 template <typename T>
-Problem<T> initMatrix(Config const &config) {
-  std::ifstream fs(config.inputFile, std::ios::binary);
-  size_t width, height;
+Problem<T> initMappedMatrix(Config const &config, std::shared_ptr<MappedFile> inputFile) {
+  auto workFile = std::make_shared<MappedFile>(config.inputFile, true);
+
+  if (inputFile->size() < 2 * sizeof(size_t)) {
+    throw std::runtime_error("invalid input file " + config.inputFile);
+  }
 
   // read the size of the matrix
-  fs.read(reinterpret_cast<char *>(&width), sizeof(width));
-  fs.read(reinterpret_cast<char *>(&height), sizeof(height));
+  size_t width = *inputFile->at<size_t>(0);
+  size_t height = *inputFile->at<size_t>(sizeof(size_t));
+  size_t matrixOffset = 2 * sizeof(size_t);
+  size_t resultOffset = matrixOffset + width * height * sizeof(T);
+  size_t triangularOffset = resultOffset + height * sizeof(T);
+  size_t solutionOffset = triangularOffset + width * height * sizeof(T);
+  size_t fileSize = solutionOffset + height * sizeof(T);
+
+  if (inputFile->size() < fileSize) {
+    throw std::runtime_error("truncated input file " + config.inputFile);
+  }
+
+  // the file is read once from the beginning to the end
+  inputFile->advise(0, fileSize, MADV_SEQUENTIAL);
+
+  // the matrix is built on the mapping only if it can be used as is, otherwise it is converted
+  // or read by the graph in a separate buffer
+  auto placement = makeNumaPlacement(config.numa);
+  bool inPlace = !config.stream && config.layout == MatrixLayouts::RowMajor && !placement;
+  std::shared_ptr<Arena> arena = nullptr;
+  std::shared_ptr<MatrixData<T, MatrixTypes::Matrix>> matrix = nullptr;
+
+  if (inPlace) {
+    workFile->advise(matrixOffset, triangularOffset - matrixOffset, MADV_SEQUENTIAL);
+    workFile->advise(matrixOffset, triangularOffset - matrixOffset, MADV_WILLNEED);
+    matrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            width, height, config.blockSize, workFile->at<T>(matrixOffset));
+  } else {
+    arena = std::make_shared<Arena>(
+            ArenaSize<T>().add(MatrixData<T>::bufferSize(width, height, config.blockSize, config.layout)).size(),
+            config.hugePages);
+    matrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            width, height, config.blockSize, *arena, config.layout);
+    if (placement) {
+      placement->place(*matrix);
+    }
+  }
 
-  auto matrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
-          width, height, config.blockSize, new T[width * height]());
   auto result = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(
-          1, height, config.blockSize, new T[height]());
+          1, height, config.blockSize, workFile->at<T>(resultOffset));
   auto saveMatrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
-          width, height, config.blockSize, new T[width * height]());
+          width, height, config.blockSize, inputFile->at<T>(matrixOffset));
   auto saveResult = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(
-          1, height, config.blockSize, new T[height]());
+          1, height, config.blockSize, inputFile->at<T>(resultOffset));
 #ifdef TESTING
   auto triangular = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
-          width, height, config.blockSize, new T[width * height]());
+          width, height, config.blockSize, inputFile->at<T>(triangularOffset));
   auto solution = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(
-          1, height, config.blockSize, new T[height]());
+          1, height, config.blockSize, inputFile->at<T>(solutionOffset));
+  Problem<T> problem(matrix, result, saveMatrix, saveResult, triangular, solution);
+#else
+  Problem<T> problem(matrix, result, saveMatrix, saveResult);
 #endif
-
-  // read the symmetric matrix
-  for (size_t i = 0; i < width * height; ++i) {
-    fs.read(reinterpret_cast<char *>(matrix->get() + i), sizeof(matrix->get()[i]));
-    saveMatrix->get()[i] = matrix->get()[i];
+  if (!inPlace && !config.stream) {
+    // layout conversion, the tile rows are read in parallel
+    size_t rowSize = width * config.blockSize * sizeof(T);
+    parallelRead<T>(config.inputFile, matrix->nbBlocksRows(),
+                    [&](size_t iBlock) {
+                      return FileRange{matrixOffset + iBlock * rowSize,
+                                       std::min(rowSize, resultOffset - matrixOffset - iBlock * rowSize)};
+                    },
+                    [&](size_t iBlock, T const *tileRow) {
+                      copyTileRow(*matrix, iBlock, tileRow, matrix->nbBlocksCols() - 1);
+                    });
+  }
+  if (config.stream) {
+    problem.stream = std::make_shared<MatrixStreamData<T>>(config.inputFile, matrixOffset, false, matrix);
   }
+  problem.arena = arena;
+  problem.inputFile = inputFile;
+  problem.workFile = workFile;
+  return problem;
+}
+
+/// @brief Loads a problem stored in the packed format (see io/packed_format.h). The lower
+/// triangular tiles are copied in the matrices, the upper part of the matrices is zero.
+template <typename T>
+Problem<T> initPackedMatrix(Config const &config, std::shared_ptr<MappedFile> inputFile) {
+  PackedHeader header = readPackedHeader<T>(*inputFile, config.inputFile);
+  PackedFileOffsets<T> offsets(header);
+  size_t size = header.size;
+  bool hasExpected = header.flags & PackedHasExpected;
+  size_t matrixSize = MatrixData<T>::bufferSize(size, size, config.blockSize, config.layout);
+  ArenaSize<T> arenaSize;
 
-  // read the result vector
-  for (size_t i = 0; i < height; ++i) {
-    fs.read(reinterpret_cast<char *>(result->get() + i), sizeof(result->get()[i]));
-    saveResult->get()[i] = result->get()[i];
+  if (config.stream && header.blockSize != config.blockSize) {
+    throw std::runtime_error("the block size of " + config.inputFile + " is "
+                             + std::to_string(header.blockSize) + ", it must be used to stream the matrix");
   }
+  inputFile->advise(0, offsets.end, MADV_SEQUENTIAL);
 
+  // matrix, result, saved result, saved matrix (not streamed), expected values (testing)
+  arenaSize.add(matrixSize).add(size).add(size);
+  if (!config.stream) {
+    arenaSize.add(size * size);
+  }
 #ifdef TESTING
-  // read the expected triangular matrix
-  for (size_t i = 0; i < width * height; ++i) {
-    fs.read(reinterpret_cast<char *>(triangular->get() + i), sizeof(triangular->get()[i]));
+  if (hasExpected) {
+    arenaSize.add(size * size).add(size);
+  }
+#endif
+  auto arena = std::make_shared<Arena>(arenaSize.size(), config.hugePages);
+
+  auto matrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+          size, size, config.blockSize, *arena, config.layout);
+  auto result = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(1, size, config.blockSize, *arena);
+  std::shared_ptr<MatrixData<T, MatrixTypes::Matrix>> saveMatrix = nullptr;
+  auto placement = makeNumaPlacement(config.numa);
+
+  if (placement) {
+    placement->place(*matrix);
+  }
+  auto saveResult = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(1, size, config.blockSize, *arena);
+  auto tileRowRange = [&](size_t offset) {
+    return [&offsets, offset](size_t iBlock) {
+      return FileRange{offset + offsets.layout.tileRowOffset(iBlock) * sizeof(T),
+                       offsets.layout.tileRowSize(iBlock) * sizeof(T)};
+    };
+  };
+
+  std::memcpy(result->get(), inputFile->at<T>(offsets.result), size * sizeof(T));
+  saveResult->reset(result);
+
+  // The buffers of a new arena are zero, so only the lower tiles are written. The tile rows are
+  // read by a pool of threads (the pages are touched first by these threads). When the matrix is
+  // streamed, the tiles are read by the graph.
+  if (!config.stream) {
+    saveMatrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(size, size, config.blockSize, *arena);
+    parallelRead<T>(config.inputFile, offsets.layout.nbBlocks, tileRowRange(offsets.matrix),
+                    [&](size_t iBlock, T const *tileRow) {
+                      unpackTileRow(offsets.layout, iBlock, tileRow, *matrix);
+                      unpackTileRow(offsets.layout, iBlock, tileRow, *saveMatrix);
+                    });
   }
 
-  // read the solution vector
-  for (size_t i = 0; i < height; ++i) {
-    fs.read(reinterpret_cast<char *>(solution->get() + i), sizeof(solution->get()[i]));
+  Problem<T> problem(matrix, result, saveMatrix, saveResult);
+#ifdef TESTING
+  if (hasExpected) {
+    problem.expectedMatrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            size, size, config.blockSize, *arena);
+    problem.expectedSolution = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(
+            1, size, config.blockSize, *arena);
+    parallelRead<T>(config.inputFile, offsets.layout.nbBlocks, tileRowRange(offsets.expectedMatrix),
+                    [&](size_t iBlock, T const *tileRow) {
+                      unpackTileRow(offsets.layout, iBlock, tileRow, *problem.expectedMatrix);
+                    });
+    std::memcpy(problem.expectedSolution->get(), inputFile->at<T>(offsets.expectedSolution), size * sizeof(T));
   }
 #endif
+  if (config.stream) {
+    problem.stream = std::make_shared<MatrixStreamData<T>>(config.inputFile, offsets.matrix, true, matrix);
+  }
+  problem.arena = arena;
+  return problem;
+}
+
+/// @brief Out-of-core mode: the lower tiles of the input matrix are copied in the file of a tile
+/// cache and the matrix has no buffer (the tiles are loaded in the cache by the states of the
+/// graph). Only the vectors are kept in memory, the saved and expected matrices are views on the
+/// input file when it is in the row major format (they are not loaded for packed files).
+template <typename T>
+Problem<T> initOutOfCoreMatrix(Config const &config, std::shared_ptr<MappedFile> inputFile) {
+  bool packed = isPackedFile(*inputFile);
+  size_t blockSize = config.blockSize;
+  size_t size = 0;
+  size_t matrixOffset = 0, resultOffset = 0, triangularOffset = 0, solutionOffset = 0;
+  bool hasExpected = true;
+  std::shared_ptr<PackedLayout> layout = nullptr;
+
+  if (config.stream) {
+    throw std::runtime_error("the matrix cannot be streamed in out-of-core mode");
+  }
+  if (packed) {
+    PackedHeader header = readPackedHeader<T>(*inputFile, config.inputFile);
+    PackedFileOffsets<T> offsets(header);
+
+    if (header.blockSize != blockSize) {
+      throw std::runtime_error("the block size of " + config.inputFile + " is "
+                               + std::to_string(header.blockSize) + ", it must be used in out-of-core mode");
+    }
+    size = header.size;
+    layout = std::make_shared<PackedLayout>(offsets.layout);
+    matrixOffset = offsets.matrix;
+    resultOffset = offsets.result;
+    solutionOffset = offsets.expectedSolution;
+    hasExpected = header.flags & PackedHasExpected;
+  } else {
+    size = *inputFile->at<size_t>(sizeof(size_t));
+    matrixOffset = 2 * sizeof(size_t);
+    resultOffset = matrixOffset + size * size * sizeof(T);
+    triangularOffset = resultOffset + size * sizeof(T);
+    solutionOffset = triangularOffset + size * size * sizeof(T);
+    if (inputFile->size() < solutionOffset + size * sizeof(T)) {
+      throw std::runtime_error("truncated input file " + config.inputFile);
+    }
+  }
+  inputFile->advise(0, inputFile->size(), MADV_SEQUENTIAL);
+
+  // the cache has to hold at least the blocks used by all the tasks at the same time
+  size_t nbBlocks = size / blockSize + (size % blockSize ? 1 : 0);
+  size_t nbThreads = config.threadsConfig.nbThreadsComputeDiagonalTask
+                   + config.threadsConfig.nbThreadsComputeColumnTask
+                   + config.threadsConfig.nbThreadsUpdateTask
+                   + config.threadsConfig.nbThreadsSolveDiagonal
+                   + config.threadsConfig.nbThreadsUpdateVector;
+  size_t capacity = std::max((config.cacheSize << 20) / (blockSize * blockSize * sizeof(T)), 3 * nbThreads);
+  auto cache = std::make_shared<TileCache<T>>(config.tileFile, nbBlocks, nbBlocks, blockSize,
+                                              capacity, config.hugePages);
+
+  // the tile rows are copied in parallel (the largest first), the tiles are written with pwrite
+  parallelFor(nbBlocks, [&](size_t row) {
+    static thread_local std::vector<T> tile;
+    size_t iBlock = nbBlocks - 1 - row;
+
+    tile.resize(blockSize * blockSize);
+    for (size_t jBlock = 0; jBlock <= iBlock; ++jBlock) {
+      size_t height = std::min(blockSize, size - iBlock * blockSize);
+      size_t width = std::min(blockSize, size - jBlock * blockSize);
+      T const *src = packed
+                   ? inputFile->at<T>(matrixOffset) + layout->tileOffset(iBlock, jBlock)
+                   : inputFile->at<T>(matrixOffset) + iBlock * blockSize * size + jBlock * blockSize;
+      size_t ld = packed ? width : size;
+
+      std::fill(tile.begin(), tile.end(), 0);
+      for (size_t i = 0; i < height; ++i) {
+        std::memcpy(tile.data() + i * blockSize, src + i * ld, width * sizeof(T));
+      }
+      cache->store(iBlock * nbBlocks + jBlock, tile.data());
+    }
+  });
+
+  auto arena = std::make_shared<Arena>(ArenaSize<T>().add(size).add(size).add(size).size(), config.hugePages);
+  auto matrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+          size, size, blockSize, nullptr, MatrixLayouts::TileMajor);
+  auto result = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(1, size, blockSize, *arena);
+  auto saveResult = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(1, size, blockSize, *arena);
+  std::shared_ptr<MatrixData<T, MatrixTypes::Matrix>> saveMatrix = nullptr;
+
+  matrix->cache(cache);
+  std::memcpy(result->get(), inputFile->at<T>(resultOffset), size * sizeof(T));
+  saveResult->reset(result);
+  if (!packed) {
+    saveMatrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            size, size, blockSize, inputFile->at<T>(matrixOffset));
+  }
 
+  Problem<T> problem(matrix, result, saveMatrix, saveResult);
 #ifdef TESTING
-  return Problem(matrix, result, saveMatrix, saveResult, triangular, solution);
-#else
-  return InitType(matrix, result, saveMatrix, saveResult);
+  if (hasExpected) {
+    problem.expectedSolution = std::make_shared<MatrixData<T, MatrixTypes::Vector>>(1, size, blockSize, *arena);
+    std::memcpy(problem.expectedSolution->get(), inputFile->at<T>(solutionOffset), size * sizeof(T));
+  }
+  if (!packed) {
+    problem.expectedMatrix = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            size, size, blockSize, inputFile->at<T>(triangularOffset));
+  }
 #endif
+  problem.arena = arena;
+  problem.inputFile = inputFile;
+  return problem;
 }
 
+/// @brief Out-of-core mode: writes the tiles that are still in the cache and maps the file of the
+/// cache, so the decomposed matrix can be verified and printed.
 template <typename T>
-void free(Problem<T> &problem) {
-  delete[] problem.matrix->get();
-  delete[] problem.result->get();
-  delete[] problem.baseMatrix->get();
-  delete[] problem.baseResult->get();
-  if (problem.expectedMatrix) {
-    delete[] problem.expectedMatrix->get();
+void syncOutOfCore(Problem<T> &problem) {
+  TileCache<T> *cache = problem.matrix->cache();
+
+  if (cache) {
+    cache->flush();
+    std::shared_ptr<MappedFile> tileFile = std::make_shared<MappedFile>(cache->fileName());
+    auto decomposed = std::make_shared<MatrixData<T, MatrixTypes::Matrix>>(
+            problem.matrix->width(), problem.matrix->height(), problem.matrix->blockSize(),
+            tileFile->at<T>(0), MatrixLayouts::TileMajor);
+    problem.matrix = decomposed;
+    problem.tileFile = tileFile;
+  }
+}
+
+/// @brief Loads the problem, the format of the file is detected automatically.
+template <typename T>
+Problem<T> initMatrix(Config const &config) {
+  auto inputFile = std::make_shared<MappedFile>(config.inputFile);
+
+  // the files of the generator store doubles, the packed files store their scalar type
+  if (!std::is_same_v<T, double> && !isPackedFile(*inputFile)) {
+    throw std::runtime_error(config.inputFile + " contains doubles, it has to be converted with "
+                             "cholesky-convert -p float");
   }
-  if (problem.expectedSolution) {
-    delete[] problem.expectedSolution->get();
+  if (!config.tileFile.empty()) {
+    return initOutOfCoreMatrix<T>(config, inputFile);
+  } else if (isPackedFile(*inputFile)) {
+    return initPackedMatrix<T>(config, inputFile);
   }
+  return initMappedMatrix<T>(config, inputFile);
+}
+
+template <typename T>
+void free(Problem<T> &problem) {
+  problem.arena = nullptr;
+  problem.inputFile = nullptr;
+  problem.workFile = nullptr;
+  problem.tileFile = nullptr;
 }
 
 /******************************************************************************/
@@ -166,10 +432,11 @@ bool verifySolution(std::shared_ptr<MatrixData<Type, MatrixTypes::Vector>> found
 template <typename Type>
 void verifySolution(Problem<Type> const &problem, Type precision) {
 #ifdef TESTING
-  if (!verifySolution(problem.matrix, problem.expectedMatrix, precision)) {
+  // the expected values are not always available (packed files, out-of-core mode)
+  if (problem.expectedMatrix && !verifySolution(problem.matrix, problem.expectedMatrix, precision)) {
     std::cerr << "ERROR: wrong decomposition" << std::endl;
   }
-  if (!verifySolution(problem.result, problem.expectedSolution, precision)) {
+  if (problem.expectedSolution && !verifySolution(problem.result, problem.expectedSolution, precision)) {
     std::cerr << "ERROR: wrong solution" << std::endl;
   }
 #endif